@@ -14,6 +14,8 @@ int main()
     Config::timeStep = 0.005;
     Config::timeBegin = 0;
     Config::timeEnd = 1;
+    // Keeps 21 of 201 time points for the post processor
+    Config::snapshotInterval = 10;
     Config::pTolerance = 1e-2;
     Config::maxIterations = 1000;
     Config::uSystemTolerance = 1e-3;
@@ -25,6 +27,7 @@ int main()
         (
             #include "cylinder_mesh.h"
         )
+        , true
     };
     mesh.useNonOrthogonalCorrection = true;
 
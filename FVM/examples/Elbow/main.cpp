@@ -25,6 +25,7 @@ int main()
         (
             #include "elbow_mesh.h"
         )
+        , true
     };
 
     mesh.useNonOrthogonalCorrection = false;
@@ -9,10 +9,13 @@ int main(int argc, char** argv)
     Config::viscosity = 1;
     Config::uRelax = 0.3;
     Config::pRelax = 0.1;
+    // Pressure correction matrix is symmetric on cartesian mesh
+    Config::pSolver = LinearSolvers::Solver::CG;
+    Config::pPreconditioner = LinearSolvers::Preconditioner::GMG;
     constexpr Scalar inletVelocity = 0.03;
     constexpr Scalar outletPressure = 0;
 
-    CartesianMesh2D mesh(10, 10, 1.0, 0.2);
+    CartesianMesh2D mesh(10, 10, 1.0, 0.2, true);
     mesh.setBottomBoundary(Boundaries::wall());
     mesh.setTopBoundary(Boundaries::wall());
     mesh.setRightBoundary(Boundaries::outlet(outletPressure));
@@ -12,9 +12,12 @@ int main(int argc, char** argv)
     Config::timeStep = 0.05;
     Config::timeBegin = 0;
     Config::timeEnd = 5;
+    // Pressure correction matrix is symmetric on cartesian mesh
+    Config::pSolver = LinearSolvers::Solver::CG;
+    Config::pPreconditioner = LinearSolvers::Preconditioner::GMG;
     constexpr Scalar wallVelocity = 0.03;
 
-    CartesianMesh2D mesh(50, 50, 1.0, 1.0);
+    CartesianMesh2D mesh(50, 50, 1.0, 1.0, true);
     mesh.setBottomBoundary(Boundaries::outlet(0));
     mesh.setTopBoundary(Boundaries::movingWall({wallVelocity, 0, 0}));
     mesh.setRightBoundary(Boundaries::wall());
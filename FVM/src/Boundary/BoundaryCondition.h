@@ -3,6 +3,7 @@
 #include "Utils/Types.h"
 #include "Utils/TypesOperations.h"
 #include <functional>
+#include <utility>
 
 
 enum class BoundaryConditionType
@@ -48,12 +49,26 @@ template<class T>
 using BoundaryConditionGetter = std::function<BoundaryCondition<T>(Index)>;
 
 
+// Interpolation templates accept any callable BoundaryCondition<T>(Index),
+// concrete getter types let the lookups be inlined into face kernels
+template<class Getter>
+using BoundaryValueType = decltype(std::declval<Getter const&>()(Index()).value);
+
+
 template<class T>
-BoundaryConditionGetter<T> zeroGradGetter()
+class ZeroGradientGetter
 {
-    return [](Index) -> BoundaryCondition<T>
+public:
+
+    BoundaryCondition<T> operator()(Index) const
     {
-        static auto boundary = BoundaryCondition<T>::fixedGradient(zero<T>());
-        return boundary;
-    };
+        return BoundaryCondition<T>::fixedGradient(zero<T>());
+    }
+};
+
+
+template<class T>
+ZeroGradientGetter<T> zeroGradGetter()
+{
+    return {};
 }
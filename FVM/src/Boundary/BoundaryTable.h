@@ -0,0 +1,70 @@
+#pragma once
+
+#include "BoundaryCondition.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+// Boundary conditions of a single variable stored densely per boundary face,
+// lookup is a few array reads instead of hashing and indirect calls
+template<class T>
+class BoundaryTable
+{
+public:
+
+    BoundaryTable() = default;
+
+    explicit BoundaryTable(Index faceAmount) : m_faceSlots(faceAmount, -1) {}
+
+    BoundaryCondition<T> operator()(Index faceIdx) const
+    {
+        Index slot = m_faceSlots[faceIdx];
+        assert(slot >= 0 && "Boundary condition is not set for the face");
+
+        return {m_values[slot], m_types[slot]};
+    }
+
+    bool contains(Index faceIdx) const
+    {
+        return faceIdx < static_cast<Index>(m_faceSlots.size()) && m_faceSlots[faceIdx] >= 0;
+    }
+
+    // Amount of faces with boundary condition
+    Index size() const
+    {
+        return static_cast<Index>(m_values.size());
+    }
+
+    void set(Index faceIdx, BoundaryCondition<T> const& boundary)
+    {
+        Index& slot = m_faceSlots[faceIdx];
+        if (slot < 0)
+        {
+            slot = size();
+            m_values.push_back(boundary.value);
+            m_types.push_back(boundary.type);
+        }
+        else
+        {
+            m_values[slot] = boundary.value;
+            m_types[slot] = boundary.type;
+        }
+    }
+
+    // Same types with zero values, e.g. for correction equations
+    BoundaryTable homogeneous() const
+    {
+        BoundaryTable result = *this;
+        std::fill(result.m_values.begin(), result.m_values.end(), zero<T>());
+        return result;
+    }
+
+private:
+
+    // Position in the arrays below, -1 if the face has no boundary condition
+    List<Index> m_faceSlots;
+
+    List<T> m_values;
+    List<BoundaryConditionType> m_types;
+};
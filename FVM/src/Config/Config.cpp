@@ -8,18 +8,40 @@ Scalar Config::viscosity = 1e-3;
 
 Scalar Config::uRelax = 0.7;
 Scalar Config::pRelax = 0.3;
+Scalar Config::coupledURelax = 1;
 
 Scalar Config::uTolerance = 1e-5;
 Scalar Config::pTolerance = 1e-5;
 Index  Config::maxIterations = 10'000;
+Index  Config::pisoCorrectors = 2;
 
 Scalar Config::uSystemTolerance = std::numeric_limits<Scalar>::epsilon();
 Scalar Config::pSystemTolerance = std::numeric_limits<Scalar>::epsilon();
+bool Config::adaptiveSystemTolerance = false;
+Scalar Config::coupledSystemTolerance = 1e-3;
+Index Config::maxSystemIterations = 0;
+
+LinearSolvers::Solver::Type Config::uSolver = LinearSolvers::Solver::BICGSTAB;
+LinearSolvers::Preconditioner::Type Config::uPreconditioner = LinearSolvers::Preconditioner::JACOBI;
+LinearSolvers::Solver::Type Config::pSolver = LinearSolvers::Solver::BICGSTAB;
+LinearSolvers::Preconditioner::Type Config::pPreconditioner = LinearSolvers::Preconditioner::JACOBI;
+LinearSolvers::MultigridCycle::Type Config::multigridCycle = LinearSolvers::MultigridCycle::V;
+Scalar Config::preconditionerRefreshThreshold = 0.1;
+LinearSolvers::SparseFormat::Type Config::sparseFormat = LinearSolvers::SparseFormat::CSR;
+bool Config::mixedPrecision = false;
+std::string Config::linearSolverLog = "";
 
 Scalar Config::timeStep = 0;
 Scalar Config::timeBegin = 0;
 Scalar Config::timeEnd = 0;
+bool Config::adaptiveTimeStep = false;
+Scalar Config::targetCourant = 1;
+Scalar Config::minTimeStep = 0;
+Scalar Config::maxTimeStep = std::numeric_limits<Scalar>::max();
+Index Config::snapshotInterval = 1;
 
 using namespace Interpolation::Schemes;
 Gradient::Type Config::gradientScheme = Gradient::GREEN_GAUSE;
 Convection::Type Config::convectionScheme = Convection::SOU;
+bool Config::deferredCorrection = false;
+bool Config::simplec = false;
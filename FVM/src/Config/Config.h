@@ -1,5 +1,8 @@
 #include "Utils/Types.h"
 #include "Discretization/Schemes/InterpolationSchemes.h"
+#include "Utils/LinearSolvers/LinearSolverTypes.h"
+
+#include <string>
 
 
 class Config
@@ -12,21 +15,62 @@ public:
     
     static Scalar uRelax;
     static Scalar pRelax;
+    // Implicit velocity relaxation of the coupled solver, pressure isn't relaxed there.
+    // Relaxation is a pseudo time step for it, so values below one slow it down a lot
+    static Scalar coupledURelax;
 
     // For transient solver
     static Scalar timeStep;
     static Scalar timeBegin;
     static Scalar timeEnd;
+    // SIMPLE adapts the time step to the target Courant number within the bounds
+    static bool adaptiveTimeStep;
+    static Scalar targetCourant;
+    static Scalar minTimeStep;
+    static Scalar maxTimeStep;
+    // Every N-th time point is kept in memory besides the latest one, zero keeps only the latest.
+    // Solvers pass all of them to snapshot sinks
+    static Index snapshotInterval;
 
     static Scalar uTolerance;
     static Scalar pTolerance;
     static Index maxIterations;
+    // Pressure correctors per time step of PISO, single corrector is unstable at larger steps
+    static Index pisoCorrectors;
     
     // Tolerance for lienar system solvers
     static Scalar uSystemTolerance;
     static Scalar pSystemTolerance;
+    // Inexact SIMPLE, tolerances follow the pressure residual and the ones above are lower bounds
+    static bool adaptiveSystemTolerance;
+    // Coupled solver, reduction of the block system residual on each outer iteration
+    static Scalar coupledSystemTolerance;
+    // Non positive value means twice the system size
+    static Index maxSystemIterations;
+
+    // Linear system solvers
+    static LinearSolvers::Solver::Type uSolver;
+    static LinearSolvers::Preconditioner::Type uPreconditioner;
+    // CG with IC0 fits pressure correction on orthogonal meshes, its matrix is symmetric there
+    static LinearSolvers::Solver::Type pSolver;
+    static LinearSolvers::Preconditioner::Type pPreconditioner;
+    // Geometric multigrid is used only on cartesian meshes, others fall back to AMG
+    static LinearSolvers::MultigridCycle::Type multigridCycle;
+    // Relative change of matrix diagonal after which preconditioners are rebuilt
+    static Scalar preconditionerRefreshThreshold;
+    // SELL layout vectorizes products on wide SIMD, CSR is cheaper to update
+    static LinearSolvers::SparseFormat::Type sparseFormat;
+    // Krylov iterations in float refined in double, halves memory traffic of the solvers
+    static bool mixedPrecision;
+    // CSV file with statistics of every linear solve, empty path disables it
+    static std::string linearSolverLog;
 
     // Interpolation schemes
     static Interpolation::Schemes::Gradient::Type gradientScheme;
     static Interpolation::Schemes::Convection::Type convectionScheme;
+    // Upwind implicit convection with explicit high order correction
+    static bool deferredCorrection;
+
+    // SIMPLEC pressure-velocity coupling, pRelax is ignored
+    static bool simplec;
 };
@@ -0,0 +1,102 @@
+#include "GradientOperator.h"
+#include "Schemes/GradientComputation.h"
+
+#include <cassert>
+
+
+template<class T>
+template<class Getter>
+GradientOperator<T>::GradientOperator
+(
+    MeshBase const& mesh,
+    Getter const& boundaries,
+    Interpolation::Schemes::Gradient::Type schemeType
+)
+{
+    Index totalCells = mesh.getCellAmount();
+    m_dimension = mesh.getDimension();
+
+    using Triplet = Eigen::Triplet<Scalar>;
+    List<Triplet> triplets;
+    m_bias.resize(totalCells);
+
+    for (Index cellIdx = 0; cellIdx < totalCells; cellIdx++)
+    {
+        auto gradient = Interpolation::computeCellGradient(mesh, cellIdx, boundaries, schemeType);
+
+        for (auto [coeff, varIdx] : gradient.terms)
+        {
+            for (Index d = 0; d < m_dimension; d++)
+            {
+                triplets.emplace_back(m_dimension*cellIdx + d, varIdx, coeff(d));
+            }
+        }
+        m_bias(cellIdx) = gradient.bias;
+    }
+
+    m_matrix = SparseMatrix(m_dimension*totalCells, totalCells);
+    m_matrix.setFromTriplets(triplets.begin(), triplets.end());
+    m_matrix.makeCompressed();
+}
+
+
+static void addToComponent(Vector& gradient, Index d, Scalar value)
+{
+    gradient(d) += value;
+}
+
+static void addToComponent(Tensor& gradient, Index d, Vector const& value)
+{
+    gradient.col(d) += value;
+}
+
+
+template<class T>
+Field<typename GradientOperator<T>::GradientType> GradientOperator<T>::evaluate(Field<T> const& field) const
+{
+    Index totalCells = getCellAmount();
+    assert(field.rows() == m_matrix.cols());
+
+    Field<GradientType> result(totalCells);
+
+    Scalar const* values = m_matrix.valuePtr();
+    Index const* columns = m_matrix.innerIndexPtr();
+    Index const* rowStarts = m_matrix.outerIndexPtr();
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index cellIdx = 0; cellIdx < totalCells; cellIdx++)
+    {
+        GradientType gradient = m_bias(cellIdx);
+        for (Index d = 0; d < m_dimension; d++)
+        {
+            Index row = m_dimension*cellIdx + d;
+            T component = zero<T>();
+            for (Index k = rowStarts[row]; k < rowStarts[row+1]; k++)
+            {
+                component += values[k] * field(columns[k]);
+            }
+            addToComponent(gradient, d, component);
+        }
+        result(cellIdx) = gradient;
+    }
+
+    return result;
+}
+
+
+template<class T>
+Index GradientOperator<T>::getCellAmount() const
+{
+    return m_bias.rows();
+}
+
+
+#define INSTANTIATE_GRADIENT_OPERATOR(T)                                                                                                    \
+template class GradientOperator<T>;                                                                                                         \
+template GradientOperator<T>::GradientOperator(MeshBase const&, BoundaryTable<T> const&, Interpolation::Schemes::Gradient::Type);           \
+template GradientOperator<T>::GradientOperator(MeshBase const&, BoundaryConditionGetter<T> const&, Interpolation::Schemes::Gradient::Type); \
+
+INSTANTIATE_GRADIENT_OPERATOR(Scalar)
+INSTANTIATE_GRADIENT_OPERATOR(Vector)
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Utils/Types.h"
+#include "Utils/TypesOperations.h"
+#include "Mesh/MeshBase.h"
+#include "Boundary/BoundaryCondition.h"
+#include "Boundary/BoundaryTable.h"
+#include "Schemes/InterpolationSchemes.h"
+
+
+// Cell gradient of the whole field as a sparse linear operator
+// Coefficients depend only on geometry and boundary conditions,
+// so operator is built once and evaluated by single SpMV
+template<class T>
+class GradientOperator
+{
+public:
+
+    using GradientType = ProductType<T, Vector>::type;
+
+    GradientOperator() = default;
+
+    // Instantiated for BoundaryTable and BoundaryConditionGetter
+    template<class Getter>
+    GradientOperator
+    (
+        MeshBase const& mesh,
+        Getter const& boundaries,
+        Interpolation::Schemes::Gradient::Type schemeType
+    );
+
+    Field<GradientType> evaluate(Field<T> const& field) const;
+
+    Index getCellAmount() const;
+
+private:
+
+    // z derivatives are zero in 2D, so their rows are not stored.
+    // Evaluated gradients are still full 3D values
+    Index m_dimension = 3;
+
+    // Row (dimension*cellIdx + d) holds coefficients of d-th gradient component in the cell
+    SparseMatrix m_matrix;
+    Field<GradientType> m_bias;
+};
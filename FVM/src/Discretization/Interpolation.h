@@ -10,19 +10,10 @@
 namespace Interpolation
 {
 
-template<class T>
-LinearCombination<T, Scalar> computeConvectionFluxOverCell
-(
-    MeshBase const& mesh, 
-    Index cellIdx, 
-    BoundaryConditionGetter<T> const& boundaries, 
-    Field<Scalar> const& massFlow,
-    Schemes::Convection::Type schemeType
-)
+template<class Getter>
+auto getConvectionSchemeImpl(Schemes::Convection::Type schemeType)
 {
-    LinearCombination<T> convectiveFlux;
-
-    decltype(&Schemes::Convection::upwindImpl<T>) schemeImpl;
+    decltype(&Schemes::Convection::upwindImpl<Getter>) schemeImpl = nullptr;
     switch (schemeType)
     {
         case Schemes::Convection::CENTRAL_DIFFERENCE:
@@ -49,57 +40,148 @@ LinearCombination<T, Scalar> computeConvectionFluxOverCell
             schemeImpl = &Schemes::Convection::quickImpl;
             break;
     }
+    return schemeImpl;
+}
 
-    for (Index faceIdx : mesh.getCellFaces(cellIdx))
-    {
-        Scalar massFlux = massFlow(faceIdx);
 
-        if (cellIdx != mesh.getFaceOwner(faceIdx))
-        {
-            massFlux *= -1;
-        }
+// Fluxes over face are directed outwards from the owner cell,
+// flux over the same face for the neighbour cell has the opposite sign
+
+template<class Getter, class T = BoundaryValueType<Getter>>
+LinearCombination<T, Scalar> computeConvectionFluxOverFace
+(
+    MeshBase const& mesh, 
+    Index faceIdx, 
+    Getter const& boundaries, 
+    Field<Scalar> const& massFlow,
+    Schemes::Convection::Type schemeType
+)
+{
+    auto schemeImpl = getConvectionSchemeImpl<Getter>(schemeType);
+
+    return massFlow(faceIdx) * (*schemeImpl)(mesh, faceIdx, boundaries, massFlow);
+}
+
 
-        convectiveFlux += 
+// Upwind implicit part, high order part goes to the bias from precomputed gradient field
+template<class Getter, class T = BoundaryValueType<Getter>>
+LinearCombination<T, Scalar> computeDeferredConvectionFluxOverFace
+(
+    MeshBase const& mesh, 
+    Index faceIdx, 
+    Getter const& boundaries, 
+    Field<Scalar> const& massFlow,
+    Schemes::Convection::Type schemeType,
+    Field<T> const& field,
+    Field<typename ProductType<T, Vector>::type> const& fieldGradient
+)
+{
+    Scalar massFlux = massFlow(faceIdx);
+
+    LinearCombination<T> convectiveFlux = massFlux * Schemes::Convection::upwindImpl(mesh, faceIdx, boundaries, massFlow);
+    convectiveFlux += T
+    (
+        massFlux *
+        Schemes::Convection::deferredCorrection
         (
-            massFlux *
-            (*schemeImpl)
-            (
-                mesh, faceIdx, boundaries, massFlow
-            )
-        );
-    }
+            mesh, faceIdx, field, fieldGradient, massFlow, schemeType
+        )
+    );
 
     return convectiveFlux;
 }
 
 
-template<class T>
-LinearCombination<T, Scalar> computeDiffusionFluxOverCell
+template<class Getter, class T = BoundaryValueType<Getter>>
+LinearCombination<T, Scalar> computeDiffusionFluxOverFace
 (
     MeshBase const& mesh, 
-    Index cellIdx, 
-    BoundaryConditionGetter<T> const& boundaries
+    Index faceIdx, 
+    Getter const& boundaries
 )
+{
+    return mesh.getFaceArea(faceIdx) *
+    computeFaceNormalGradient
+    (
+        mesh, mesh.getFaceOwner(faceIdx), faceIdx, boundaries
+    );
+}
+
+
+// Sum of the face fluxes with signs for the cell
+template<class T, class FaceFlux>
+LinearCombination<T, Scalar> sumFluxesOverCell(MeshBase const& mesh, Index cellIdx, FaceFlux const& faceFlux)
 {
     LinearCombination<T> flux;
     for (Index faceIdx : mesh.getCellFaces(cellIdx))
     {
-        Vector faceVector = mesh.getFaceVector(faceIdx);
-        if (mesh.getFaceOwner(faceIdx) != cellIdx)
+        if (cellIdx == mesh.getFaceOwner(faceIdx))
         {
-            faceVector *= -1;
+            flux += faceFlux(faceIdx);
+        }
+        else
+        {
+            flux -= faceFlux(faceIdx);
         }
-        flux += faceVector.norm() *
-        computeFaceNormalGradient
-        (
-            mesh, cellIdx, faceIdx, boundaries
-        ); 
     }
     return flux;
 }
 
 
-inline Vector computeRhieChowVelocityOnFace
+template<class Getter, class T = BoundaryValueType<Getter>>
+LinearCombination<T, Scalar> computeConvectionFluxOverCell
+(
+    MeshBase const& mesh, 
+    Index cellIdx, 
+    Getter const& boundaries, 
+    Field<Scalar> const& massFlow,
+    Schemes::Convection::Type schemeType
+)
+{
+    return sumFluxesOverCell<T>(mesh, cellIdx, [&](Index faceIdx)
+    {
+        return computeConvectionFluxOverFace(mesh, faceIdx, boundaries, massFlow, schemeType);
+    });
+}
+
+
+template<class Getter, class T = BoundaryValueType<Getter>>
+LinearCombination<T, Scalar> computeDeferredConvectionFluxOverCell
+(
+    MeshBase const& mesh, 
+    Index cellIdx, 
+    Getter const& boundaries, 
+    Field<Scalar> const& massFlow,
+    Schemes::Convection::Type schemeType,
+    Field<T> const& field,
+    Field<typename ProductType<T, Vector>::type> const& fieldGradient
+)
+{
+    return sumFluxesOverCell<T>(mesh, cellIdx, [&](Index faceIdx)
+    {
+        return computeDeferredConvectionFluxOverFace(mesh, faceIdx, boundaries, massFlow, schemeType, field, fieldGradient);
+    });
+}
+
+
+template<class Getter, class T = BoundaryValueType<Getter>>
+LinearCombination<T, Scalar> computeDiffusionFluxOverCell
+(
+    MeshBase const& mesh, 
+    Index cellIdx, 
+    Getter const& boundaries
+)
+{
+    return sumFluxesOverCell<T>(mesh, cellIdx, [&](Index faceIdx)
+    {
+        return computeDiffusionFluxOverFace(mesh, faceIdx, boundaries);
+    });
+}
+
+
+// Face must have a neighbour, used by loops over the interior faces range
+template<class VelocityGetter, class PressureGetter>
+Vector computeRhieChowVelocityOnInteriorFace
 (
     MeshBase const& mesh,
     Index faceIdx,
@@ -107,16 +189,11 @@ inline Vector computeRhieChowVelocityOnFace
     Field<Scalar> const& p,
     Field<Vector> const& pGrad,
     Field<Scalar> const& VbyA,
-    BoundaryConditionGetter<Vector> const& uBoundaries,
-    BoundaryConditionGetter<Scalar> const& pBoundaries
+    VelocityGetter const& uBoundaries,
+    PressureGetter const& pBoundaries
 )
 {
     Vector faceVelocity = valueOnFace(mesh, faceIdx, uBoundaries).evaluate(U);
-    
-    if (mesh.isBoundaryFace(faceIdx))
-    {
-        return faceVelocity;
-    }
 
     Scalar VbyA_f = valueOnFace(mesh, faceIdx, zeroGradGetter<Scalar>()).evaluate(VbyA);
 
@@ -124,11 +201,32 @@ inline Vector computeRhieChowVelocityOnFace
     Scalar faceNormalGrad = computeFaceNormalGradient(mesh, cellIdx, faceIdx, pBoundaries).evaluate(p);
     Vector avgFaceGradient = valueOnFace(mesh, faceIdx, zeroGradGetter<Vector>()).evaluate(pGrad);
     // correction
-    Vector faceVector = mesh.getFaceVector(faceIdx);
-    Vector unitNormal = faceVector.normalized();
+    Vector unitNormal = mesh.getFaceUnitNormal(faceIdx);
     Vector velocityCorrection = -VbyA_f * (faceNormalGrad - avgFaceGradient.dot(unitNormal))*unitNormal;
     
     return faceVelocity + velocityCorrection;
 }
 
+
+template<class VelocityGetter, class PressureGetter>
+Vector computeRhieChowVelocityOnFace
+(
+    MeshBase const& mesh,
+    Index faceIdx,
+    Field<Vector> const& U,
+    Field<Scalar> const& p,
+    Field<Vector> const& pGrad,
+    Field<Scalar> const& VbyA,
+    VelocityGetter const& uBoundaries,
+    PressureGetter const& pBoundaries
+)
+{
+    if (mesh.isBoundaryFace(faceIdx))
+    {
+        return valueOnFace(mesh, faceIdx, uBoundaries).evaluate(U);
+    }
+
+    return computeRhieChowVelocityOnInteriorFace(mesh, faceIdx, U, p, pGrad, VbyA, uBoundaries, pBoundaries);
+}
+
 } // namespace Interpolation
@@ -3,9 +3,9 @@
 
 
 template<class VarType, class CoeffType>
-LinearCombination<VarType, CoeffType>::LinearCombination(std::initializer_list<Term<CoeffType>> const& list) : terms(list.size())
+LinearCombination<VarType, CoeffType>::LinearCombination(std::initializer_list<Term<CoeffType>> const& list) : terms(list)
 {
-    std::copy(list.begin(), list.end(), terms.begin());
+    sortTerms();
 }
 
 
@@ -28,15 +28,17 @@ LinearCombination<VarType, CoeffType>& LinearCombination<VarType, CoeffType>::op
 template<class VarType, class CoeffType>
 LinearCombination<VarType, CoeffType>& LinearCombination<VarType, CoeffType>::operator+=(Term<CoeffType> const& term)
 {
-    auto iter = std::find_if(terms.begin(), terms.end(),
-    [&term](Term<CoeffType> const& t) 
+    sortTerms();
+
+    auto iter = std::lower_bound(terms.begin(), terms.end(), term.idx,
+    [](Term<CoeffType> const& t, Index idx) 
     {
-        return t.idx == term.idx;
+        return t.idx < idx;
     });
     
-    if (iter == terms.end())
+    if (iter == terms.end() || iter->idx != term.idx)
     {
-        terms.push_back(term);
+        terms.insert(iter, term);
     }
     else
     {
@@ -60,11 +62,7 @@ LinearCombination<VarType, CoeffType>& LinearCombination<VarType, CoeffType>::op
 template<class VarType, class CoeffType>
 LinearCombination<VarType, CoeffType>& LinearCombination<VarType, CoeffType>::operator+=(LinearCombination const& rhs)
 {
-    bias += rhs.bias;
-    for (auto const& term : rhs.terms)
-    {
-        *this += term;
-    }
+    addMapped(rhs, [](auto const& value) {return value;});
 
     return *this;
 }
@@ -73,11 +71,11 @@ LinearCombination<VarType, CoeffType>& LinearCombination<VarType, CoeffType>::op
 template<class VarType, class CoeffType>
 LinearCombination<VarType, CoeffType>& LinearCombination<VarType, CoeffType>::operator-=(LinearCombination const& rhs)
 {
-    bias -= rhs.bias;
-    for (auto const& term : rhs.terms)
+    addMapped(rhs, [](auto const& value)
     {
-        *this -= term;
-    }
+        using ValueType = std::remove_cvref_t<decltype(value)>;
+        return ValueType(-value);
+    });
 
     return *this;
 }
@@ -132,6 +130,16 @@ requires std::same_as<CoeffType, Vector>
 }
 
 
+template<class VarType, class CoeffType>
+void LinearCombination<VarType, CoeffType>::sortTerms()
+{
+    if (!std::is_sorted(terms.begin(), terms.end(), compareByIdx<CoeffType>))
+    {
+        std::sort(terms.begin(), terms.end(), compareByIdx<CoeffType>);
+    }
+}
+
+
 template<class U, class V>
 LinearCombination<U, V> operator+(LinearCombination<U, V> lhs, LinearCombination<U, V> const& rhs)
 {
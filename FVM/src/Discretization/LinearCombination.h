@@ -2,6 +2,9 @@
 
 #include "Utils/Types.h"
 #include "Utils/TypesOperations.h"
+#include "Utils/SmallList.h"
+
+#include <algorithm>
 
 template<class CoeffType>
 class Term
@@ -20,7 +23,12 @@ public:
 
     using BiasType = ProductType<VarType, CoeffType>::type;
 
-    List<Term<CoeffType>> terms;
+    // Stencils rarely exceed this size, so terms usually don't touch the heap
+    static constexpr size_t inlineTermsAmount = 16;
+    using TermList = SmallList<Term<CoeffType>, inlineTermsAmount>;
+
+    // Terms are kept sorted by index, unsorted terms are sorted on the next merge
+    TermList terms;
     BiasType bias = zero<BiasType>();
 
     LinearCombination() = default;
@@ -49,8 +57,133 @@ public:
 
     LinearCombination<VarType, Scalar> dot(Vector) const
     requires std::same_as<CoeffType, Vector>;
+
+    // Adds rhs with linear map applied to its bias and coeffs,
+    // map should return concrete types, not Eigen expressions
+    template<class RhsCoeffType, class Map>
+    void addMapped(LinearCombination<VarType, RhsCoeffType> const& rhs, Map const& map);
+
+private:
+
+    template<class C>
+    static bool compareByIdx(Term<C> const& lhs, Term<C> const& rhs)
+    {
+        return lhs.idx < rhs.idx;
+    }
+
+    void sortTerms();
 };
 
+
+template<class VarType, class CoeffType>
+template<class RhsCoeffType, class Map>
+void LinearCombination<VarType, CoeffType>::addMapped
+(
+    LinearCombination<VarType, RhsCoeffType> const& rhs,
+    Map const& map
+)
+{
+    using RhsTermList = LinearCombination<VarType, RhsCoeffType>::TermList;
+
+    bias += map(rhs.bias);
+    if (rhs.terms.empty())
+    {
+        return;
+    }
+
+    // rhs is not modified, so sorting its copy if needed
+    RhsTermList sortedRhs;
+    RhsTermList const* rhsTerms = &rhs.terms;
+    if (!std::is_sorted(rhs.terms.begin(), rhs.terms.end(), compareByIdx<RhsCoeffType>))
+    {
+        sortedRhs = rhs.terms;
+        std::sort(sortedRhs.begin(), sortedRhs.end(), compareByIdx<RhsCoeffType>);
+        rhsTerms = &sortedRhs;
+    }
+
+    sortTerms();
+
+    if (terms.empty())
+    {
+        terms.reserve(rhsTerms->size());
+        for (auto const& [coeff, idx] : *rhsTerms)
+        {
+            terms.emplace_back(CoeffType(map(coeff)), idx);
+        }
+        return;
+    }
+
+    // Counting rhs terms which are absent in lhs
+    size_t newTermsAmount = 0;
+    auto lhsIter = terms.begin();
+    for (auto const& term : *rhsTerms)
+    {
+        while (lhsIter != terms.end() && lhsIter->idx < term.idx)
+        {
+            lhsIter++;
+        }
+        if (lhsIter != terms.end() && lhsIter->idx == term.idx)
+        {
+            lhsIter++;
+        }
+        else
+        {
+            newTermsAmount++;
+        }
+    }
+
+    // Stencil of rhs is already covered, adding in place
+    if (0 == newTermsAmount)
+    {
+        lhsIter = terms.begin();
+        for (auto const& [coeff, idx] : *rhsTerms)
+        {
+            while (lhsIter->idx < idx)
+            {
+                lhsIter++;
+            }
+            lhsIter->coeff += map(coeff);
+            lhsIter++;
+        }
+        return;
+    }
+
+    TermList merged;
+    merged.reserve(terms.size() + newTermsAmount);
+
+    lhsIter = terms.begin();
+    auto rhsIter = rhsTerms->begin();
+    while (lhsIter != terms.end() && rhsIter != rhsTerms->end())
+    {
+        if (lhsIter->idx < rhsIter->idx)
+        {
+            merged.push_back(*lhsIter++);
+        }
+        else if (rhsIter->idx < lhsIter->idx)
+        {
+            merged.emplace_back(CoeffType(map(rhsIter->coeff)), rhsIter->idx);
+            rhsIter++;
+        }
+        else
+        {
+            merged.emplace_back(CoeffType(lhsIter->coeff + map(rhsIter->coeff)), lhsIter->idx);
+            lhsIter++;
+            rhsIter++;
+        }
+    }
+    for (; lhsIter != terms.end(); lhsIter++)
+    {
+        merged.push_back(*lhsIter);
+    }
+    for (; rhsIter != rhsTerms->end(); rhsIter++)
+    {
+        merged.emplace_back(CoeffType(map(rhsIter->coeff)), rhsIter->idx);
+    }
+
+    terms = std::move(merged);
+}
+
+
 template<class U, class V>
 LinearCombination<U,V> operator+(LinearCombination<U,V>, LinearCombination<U,V> const&);
 
@@ -0,0 +1,350 @@
+#pragma once
+
+#include "LinearCombination.h"
+
+#include <concepts>
+#include <type_traits>
+
+
+// Lazy arithmetic over LinearCombination
+// Expression is started with lazy(lc) and evaluated in a single pass
+// into the destination, intermediate combinations are not materialized.
+// Expression keeps references to the operands, so it should be consumed
+// within the same statement and not stored in auto variables.
+// Destination of += and -= shouldn't be a part of the expression.
+
+
+// Linear maps applied to the coeffs and the bias on evaluation
+
+class IdentityMap
+{
+public:
+
+    template<class X>
+    X operator()(X const& value) const {return value;}
+};
+
+
+class ScaleMap
+{
+public:
+
+    Scalar factor;
+
+    template<class X>
+    X operator()(X const& value) const {return X(factor * value);}
+};
+
+
+class RightOuterProductMap
+{
+public:
+
+    Vector vec;
+
+    template<class X>
+    auto operator()(X const& value) const {return outerProduct(value, vec);}
+};
+
+
+class LeftOuterProductMap
+{
+public:
+
+    Vector vec;
+
+    template<class X>
+    auto operator()(X const& value) const {return outerProduct(vec, value);}
+};
+
+
+class InnerProductMap
+{
+public:
+
+    Vector vec;
+
+    template<class X>
+    auto operator()(X const& value) const {return innerProduct(value, vec);}
+};
+
+
+// Inner map is applied first
+template<class Outer, class Inner>
+class ComposedMap
+{
+public:
+
+    Outer const& outer;
+    Inner const& inner;
+
+    template<class X>
+    auto operator()(X const& value) const {return outer(inner(value));}
+};
+
+
+class LinearExpressionTag {};
+
+template<class E>
+concept IsLinearExpression = std::derived_from<E, LinearExpressionTag>;
+
+
+template<class Inner, class Map, class CoeffType>
+class MappedExpression;
+
+
+template<class Derived, class VarT, class CoeffT>
+class LinearExpressionBase : public LinearExpressionTag
+{
+public:
+
+    using VarType    = VarT;
+    using CoeffType  = CoeffT;
+    using BiasType   = ProductType<VarType, CoeffType>::type;
+    using ResultType = LinearCombination<VarType, CoeffType>;
+
+    ResultType eval() const
+    {
+        ResultType result;
+        static_cast<Derived const&>(*this).accumulate(result, IdentityMap{});
+        return result;
+    }
+
+    operator ResultType() const {return eval();}
+
+    MappedExpression<Derived, InnerProductMap, Scalar> dot(Vector vec) const
+    requires std::same_as<CoeffType, Vector>
+    {
+        return {static_cast<Derived const&>(*this), InnerProductMap{vec}};
+    }
+};
+
+
+template<class VarType, class CoeffType>
+class LeafExpression : public LinearExpressionBase<LeafExpression<VarType, CoeffType>, VarType, CoeffType>
+{
+public:
+
+    explicit LeafExpression(LinearCombination<VarType, CoeffType> const& lc) : m_lc(lc) {}
+
+    template<class Dest, class Map>
+    void accumulate(Dest& dest, Map const& map) const
+    {
+        dest.addMapped(m_lc, map);
+    }
+
+private:
+
+    LinearCombination<VarType, CoeffType> const& m_lc;
+};
+
+
+template<class VarType, class CoeffType>
+class BiasExpression : public LinearExpressionBase<BiasExpression<VarType, CoeffType>, VarType, CoeffType>
+{
+public:
+
+    using BiasType = ProductType<VarType, CoeffType>::type;
+
+    explicit BiasExpression(BiasType const& value) : m_value(value) {}
+
+    template<class Dest, class Map>
+    void accumulate(Dest& dest, Map const& map) const
+    {
+        dest.bias += map(m_value);
+    }
+
+private:
+
+    BiasType m_value;
+};
+
+
+template<class Lhs, class Rhs, int rhsSign>
+class SumExpression : public LinearExpressionBase<SumExpression<Lhs, Rhs, rhsSign>, typename Lhs::VarType, typename Lhs::CoeffType>
+{
+public:
+
+    static_assert(std::same_as<typename Lhs::VarType, typename Rhs::VarType>);
+    static_assert(std::same_as<typename Lhs::CoeffType, typename Rhs::CoeffType>);
+
+    SumExpression(Lhs const& lhs, Rhs const& rhs) : m_lhs(lhs), m_rhs(rhs) {}
+
+    template<class Dest, class Map>
+    void accumulate(Dest& dest, Map const& map) const
+    {
+        m_lhs.accumulate(dest, map);
+        if constexpr (rhsSign > 0)
+        {
+            m_rhs.accumulate(dest, map);
+        }
+        else
+        {
+            ScaleMap negate{-1};
+            m_rhs.accumulate(dest, ComposedMap<Map, ScaleMap>{map, negate});
+        }
+    }
+
+private:
+
+    Lhs m_lhs;
+    Rhs m_rhs;
+};
+
+
+template<class Inner, class Map, class CoeffType>
+class MappedExpression : public LinearExpressionBase<MappedExpression<Inner, Map, CoeffType>, typename Inner::VarType, CoeffType>
+{
+public:
+
+    MappedExpression(Inner const& inner, Map const& map) : m_inner(inner), m_map(map) {}
+
+    template<class Dest, class OuterMap>
+    void accumulate(Dest& dest, OuterMap const& outerMap) const
+    {
+        m_inner.accumulate(dest, ComposedMap<OuterMap, Map>{outerMap, m_map});
+    }
+
+private:
+
+    Inner m_inner;
+    Map m_map;
+};
+
+
+template<class U, class V>
+LeafExpression<U, V> lazy(LinearCombination<U, V> const& lc)
+{
+    return LeafExpression<U, V>(lc);
+}
+
+
+template<class T>
+struct IsLinearCombination : std::false_type {};
+
+template<class U, class V>
+struct IsLinearCombination<LinearCombination<U, V>> : std::true_type {};
+
+// At least one operand should be an expression, otherwise eager operators are used
+template<class Lhs, class Rhs>
+concept LazyOperands =
+(
+    (IsLinearExpression<Lhs> || IsLinearCombination<Lhs>::value)
+    && (IsLinearExpression<Rhs> || IsLinearCombination<Rhs>::value)
+    && (IsLinearExpression<Lhs> || IsLinearExpression<Rhs>)
+);
+
+template<class T>
+auto asExpression(T const& operand)
+{
+    if constexpr (IsLinearExpression<T>)
+    {
+        return operand;
+    }
+    else
+    {
+        return lazy(operand);
+    }
+}
+
+template<class T>
+using ExpressionOf = decltype(asExpression(std::declval<T const&>()));
+
+
+template<class Lhs, class Rhs>
+requires LazyOperands<Lhs, Rhs>
+SumExpression<ExpressionOf<Lhs>, ExpressionOf<Rhs>, 1> operator+(Lhs const& lhs, Rhs const& rhs)
+{
+    return {asExpression(lhs), asExpression(rhs)};
+}
+
+template<class Lhs, class Rhs>
+requires LazyOperands<Lhs, Rhs>
+SumExpression<ExpressionOf<Lhs>, ExpressionOf<Rhs>, -1> operator-(Lhs const& lhs, Rhs const& rhs)
+{
+    return {asExpression(lhs), asExpression(rhs)};
+}
+
+template<IsLinearExpression E>
+SumExpression<E, BiasExpression<typename E::VarType, typename E::CoeffType>, 1>
+operator+(E const& expr, typename E::BiasType const& value)
+{
+    return {expr, BiasExpression<typename E::VarType, typename E::CoeffType>(value)};
+}
+
+template<IsLinearExpression E>
+SumExpression<E, BiasExpression<typename E::VarType, typename E::CoeffType>, 1>
+operator+(typename E::BiasType const& value, E const& expr)
+{
+    return {expr, BiasExpression<typename E::VarType, typename E::CoeffType>(value)};
+}
+
+template<IsLinearExpression E>
+SumExpression<E, BiasExpression<typename E::VarType, typename E::CoeffType>, -1>
+operator-(E const& expr, typename E::BiasType const& value)
+{
+    return {expr, BiasExpression<typename E::VarType, typename E::CoeffType>(value)};
+}
+
+template<IsLinearExpression E>
+SumExpression<BiasExpression<typename E::VarType, typename E::CoeffType>, E, -1>
+operator-(typename E::BiasType const& value, E const& expr)
+{
+    return {BiasExpression<typename E::VarType, typename E::CoeffType>(value), expr};
+}
+
+template<IsLinearExpression E>
+MappedExpression<E, ScaleMap, typename E::CoeffType> operator-(E const& expr)
+{
+    return {expr, ScaleMap{-1}};
+}
+
+template<IsLinearExpression E>
+MappedExpression<E, ScaleMap, typename E::CoeffType> operator*(E const& expr, Scalar value)
+{
+    return {expr, ScaleMap{value}};
+}
+
+template<IsLinearExpression E>
+MappedExpression<E, ScaleMap, typename E::CoeffType> operator*(Scalar value, E const& expr)
+{
+    return {expr, ScaleMap{value}};
+}
+
+template<IsLinearExpression E>
+MappedExpression<E, ScaleMap, typename E::CoeffType> operator/(E const& expr, Scalar value)
+{
+    return {expr, ScaleMap{1 / value}};
+}
+
+// Coeffs are multiplied by vector as outer product, order is kept
+template<IsLinearExpression E>
+MappedExpression<E, RightOuterProductMap, typename ProductType<typename E::CoeffType, Vector>::type>
+operator*(E const& expr, Vector const& vec)
+{
+    return {expr, RightOuterProductMap{vec}};
+}
+
+template<IsLinearExpression E>
+MappedExpression<E, LeftOuterProductMap, typename ProductType<Vector, typename E::CoeffType>::type>
+operator*(Vector const& vec, E const& expr)
+{
+    return {expr, LeftOuterProductMap{vec}};
+}
+
+
+template<class U, class V, IsLinearExpression E>
+LinearCombination<U, V>& operator+=(LinearCombination<U, V>& dest, E const& expr)
+requires std::same_as<typename E::ResultType, LinearCombination<U, V>>
+{
+    expr.accumulate(dest, IdentityMap{});
+    return dest;
+}
+
+template<class U, class V, IsLinearExpression E>
+LinearCombination<U, V>& operator-=(LinearCombination<U, V>& dest, E const& expr)
+requires std::same_as<typename E::ResultType, LinearCombination<U, V>>
+{
+    expr.accumulate(dest, ScaleMap{-1});
+    return dest;
+}
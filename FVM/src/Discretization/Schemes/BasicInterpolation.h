@@ -7,12 +7,12 @@
 namespace Interpolation
 {
 
-template<class T>
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Scalar> valueOnFace
 (
     MeshBase const& mesh, 
     Index faceIdx, 
-    BoundaryConditionGetter<T> const& boundaries
+    Getter const& boundaries
 )
 {
     if (mesh.isBoundaryFace(faceIdx))
@@ -40,25 +40,9 @@ LinearCombination<T, Scalar> valueOnFace
     // general case
     auto [cellFromIdx, cellToIdx] = mesh.getFaceNeighbors(faceIdx);
 
-    Scalar coeffFrom, coeffTo;
+    Scalar coeffFrom = mesh.getFaceWeight(faceIdx);
+    Scalar coeffTo = 1 - coeffFrom;
 
-    if (mesh.useNonOrthogonalCorrection)
-    {
-        Scalar distanceBetweenCells = Geometry::distanceCellToCell(mesh, cellFromIdx, cellToIdx);
-        Vector unitDirection = Geometry::cellToCellUnitVector(mesh, cellFromIdx, cellToIdx);
-        Scalar distanceToFace = Geometry::distanceCellToFaceInDirection(mesh, cellFromIdx, faceIdx, unitDirection);
-    
-        coeffFrom = distanceToFace / distanceBetweenCells;
-        coeffTo = 1 - coeffFrom;
-    }
-    else 
-    {
-        Scalar distFrom = Geometry::distanceCellToFace(mesh, cellFromIdx, faceIdx);
-        Scalar distTo = Geometry::distanceCellToFace(mesh, cellToIdx, faceIdx);
-    
-        coeffFrom = 1 - distFrom/ (distFrom + distTo);
-        coeffTo = 1 - coeffFrom;
-    }
     return {{coeffFrom, cellFromIdx}, {coeffTo, cellToIdx}};
 }
 
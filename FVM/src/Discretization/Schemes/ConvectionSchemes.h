@@ -3,18 +3,19 @@
 #include "GradientSchemes.h"
 #include "GradientComputation.h"
 #include "Discretization/LinearCombination.h"
+#include "Discretization/LinearExpression.h"
 #include "Mesh/Geometry.h"
 #include <iostream>
 
 namespace Interpolation::Schemes::Convection
 {
 
-template<class T>
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Scalar> centralDifferenceImpl
 (
     MeshBase const& mesh,
     Index faceIdx,
-    BoundaryConditionGetter<T> const& boundaries,
+    Getter const& boundaries,
     [[maybe_unused]] Field<Scalar> const& massFlow
 )
 {
@@ -22,12 +23,12 @@ LinearCombination<T, Scalar> centralDifferenceImpl
 }
 
 
-template<class T>
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Scalar> upwindImpl
 (
     MeshBase const& mesh,
     Index faceIdx,
-    BoundaryConditionGetter<T> const& boundaries,
+    Getter const& boundaries,
     Field<Scalar> const& massFlow
 )
 {
@@ -46,12 +47,12 @@ LinearCombination<T, Scalar> upwindImpl
 }
 
 
-template<class T>
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Scalar> downwindImpl
 (
     MeshBase const& mesh,
     Index faceIdx,
-    BoundaryConditionGetter<T> const& boundaries,
+    Getter const& boundaries,
     Field<Scalar> const& massFlow
 )
 {
@@ -70,12 +71,12 @@ LinearCombination<T, Scalar> downwindImpl
 }
 
 
-template<class T>
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Scalar> frommImpl
 (
     MeshBase const& mesh,
     Index faceIdx,
-    BoundaryConditionGetter<T> const& boundaries,
+    Getter const& boundaries,
     Field<Scalar> const& massFlow
 )
 {
@@ -100,18 +101,19 @@ LinearCombination<T, Scalar> frommImpl
     Vector delta = mesh.getFaceCentroid(faceIdx) - mesh.getCellCentroid(ownerIdx);
 
     LinearCombination<T, Scalar> faceValue = {{1, ownerIdx}};
-    faceValue += cellGradient.dot(delta);
+    faceValue += lazy(cellGradient).dot(delta);
+    faceValue += lazy(cellGradient).dot(delta);
 
-    return faceValue + cellGradient.dot(delta);
+    return faceValue;
 }
 
 
-template<class T>
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Scalar> souImpl
 (
     MeshBase const& mesh,
     Index faceIdx,
-    BoundaryConditionGetter<T> const& boundaries,
+    Getter const& boundaries,
     Field<Scalar> const& massFlow
 )
 {
@@ -137,16 +139,16 @@ LinearCombination<T, Scalar> souImpl
     auto faceGradient = computeFaceGradient(mesh, faceIdx, boundaries, gradientScheme);
     Vector delta = mesh.getFaceCentroid(faceIdx) - mesh.getCellCentroid(ownerIdx);
 
-    return ownerValue + Scalar(0.5) * (Scalar(2) * ownerCellGradient - faceGradient).dot(delta);
+    return lazy(ownerValue) + Scalar(0.5) * (Scalar(2) * lazy(ownerCellGradient) - faceGradient).dot(delta);
 }
 
 
-template<class T>
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Scalar> quickImpl
 (
     MeshBase const& mesh,
     Index faceIdx,
-    BoundaryConditionGetter<T> const& boundaries,
+    Getter const& boundaries,
     [[maybe_unused]] Field<Scalar> const& massFlow
 )
 {
@@ -172,7 +174,76 @@ LinearCombination<T, Scalar> quickImpl
     auto faceGradient = computeFaceGradient(mesh, faceIdx, boundaries, gradientScheme);
     Vector delta = mesh.getFaceCentroid(faceIdx) - mesh.getCellCentroid(ownerIdx);
 
-    return ownerValue + Scalar(0.5) * (ownerCellGradient + faceGradient).dot(delta);
+    return lazy(ownerValue) + Scalar(0.5) * (lazy(ownerCellGradient) + faceGradient).dot(delta);
+}
+
+
+// Deferred correction: difference between the scheme's face value and the upwind one
+// computed explicitly, gradients are taken from precomputed cell gradient field
+template<class T>
+T deferredCorrection
+(
+    MeshBase const& mesh,
+    Index faceIdx,
+    Field<T> const& field,
+    Field<typename ProductType<T, Vector>::type> const& cellGradient,
+    Field<Scalar> const& massFlow,
+    Type schemeType
+)
+{
+    using GradientType = ProductType<T, Vector>::type;
+
+    // On the boundary all schemes fall back to valueOnFace
+    if (mesh.isBoundaryFace(faceIdx))
+    {
+        return zero<T>();
+    }
+
+    auto [ownerIdx, neighbourIdx] = mesh.getFaceNeighbors(faceIdx);
+    if (massFlow(faceIdx) < 0)
+    {
+        std::swap(ownerIdx, neighbourIdx);
+    }
+
+    Vector delta = mesh.getFaceCentroid(faceIdx) - mesh.getCellCentroid(ownerIdx);
+    GradientType ownerCellGradient = cellGradient(ownerIdx);
+
+    switch (schemeType)
+    {
+        case UPWIND:
+            return zero<T>();
+
+        case DOWNWIND:
+            return T(field(neighbourIdx) - field(ownerIdx));
+
+        case CENTRAL_DIFFERENCE:
+        {
+            Index faceOwnerIdx = mesh.getFaceOwner(faceIdx);
+            Scalar ownerWeight = mesh.getFaceWeight(faceIdx);
+            T faceValue = ownerWeight * field(faceOwnerIdx) + (1 - ownerWeight) * field(ownerIdx + neighbourIdx - faceOwnerIdx);
+            return T(faceValue - field(ownerIdx));
+        }
+
+        case FROMM:
+            // Same as frommImpl
+            return Scalar(2) * innerProduct(ownerCellGradient, delta);
+
+        case SOU:
+        {
+            GradientType faceGradient = evaluateFaceGradient(mesh, faceIdx, field, cellGradient);
+            GradientType gradient = Scalar(2) * ownerCellGradient - faceGradient;
+            return Scalar(0.5) * innerProduct(gradient, delta);
+        }
+
+        case QUICK:
+        {
+            GradientType faceGradient = evaluateFaceGradient(mesh, faceIdx, field, cellGradient);
+            GradientType gradient = ownerCellGradient + faceGradient;
+            return Scalar(0.5) * innerProduct(gradient, delta);
+        }
+    }
+
+    return zero<T>();
 }
 
 } // nemespace Interpolation::Schemes::Convection
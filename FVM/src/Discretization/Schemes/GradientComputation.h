@@ -2,17 +2,18 @@
 
 #include "InterpolationSchemes.h"
 #include "GradientSchemes.h"
+#include "Discretization/LinearExpression.h"
 
 
 namespace Interpolation
 {
 
-template<class T>
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Vector> computeCellGradient
 (
     MeshBase const& mesh, 
     Index cellIdx,
-    BoundaryConditionGetter<T> const& boundaries,
+    Getter const& boundaries,
     Schemes::Gradient::Type schemeType
 )
 {
@@ -34,12 +35,12 @@ LinearCombination<T, Vector> computeCellGradient
 
 
 // Warning ! Not for boundary faces
-template<class T>
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Vector> computeAverageFaceGradient
 (
     MeshBase const& mesh,
     Index faceIdx,
-    BoundaryConditionGetter<T> const& boundaries,
+    Getter const& boundaries,
     Schemes::Gradient::Type schemeType
 )
 {
@@ -55,17 +56,17 @@ LinearCombination<T, Vector> computeAverageFaceGradient
     Scalar ownerWeight = ownerDistance / (ownerDistance + neighborDistance);
     Scalar neighborWeight = 1 - ownerWeight;
     
-    return ownerWeight * ownerCellGradient + neighborWeight * neighborCellGradient;
+    return ownerWeight * lazy(ownerCellGradient) + neighborWeight * lazy(neighborCellGradient);
 }
 
 
 // Warning ! Not for boundary faces
-template<class T>
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Vector> computeFaceGradient
 (
     MeshBase const& mesh,
     Index faceIdx,
-    BoundaryConditionGetter<T> const& boundaries,
+    Getter const& boundaries,
     Schemes::Gradient::Type schemeType
 )
 {
@@ -77,8 +78,8 @@ LinearCombination<T, Vector> computeFaceGradient
     }
 
     auto [ownerIdx, neighborIdx] = mesh.getFaceNeighbors(faceIdx);
-    Vector unitDirection = Geometry::cellToCellUnitVector(mesh, ownerIdx, neighborIdx);
-    Scalar distanceBetweenCells = Geometry::distanceCellToCell(mesh, ownerIdx, neighborIdx);
+    Vector unitDirection = Geometry::cellToCellUnitVectorAcrossFace(mesh, ownerIdx, faceIdx);
+    Scalar distanceBetweenCells = Geometry::distanceCellToCellAcrossFace(mesh, faceIdx);
 
     LinearCombination<T, Scalar> finiteDifference = 
     {
@@ -86,19 +87,56 @@ LinearCombination<T, Vector> computeFaceGradient
         {-1 / distanceBetweenCells, neighborIdx}
     };
 
-    auto nonOrthogonalCorrection = (finiteDifference - avgFaceGradient.dot(unitDirection)) * unitDirection;
-
-    return avgFaceGradient + nonOrthogonalCorrection;
+    return lazy(avgFaceGradient) + (finiteDifference - lazy(avgFaceGradient).dot(unitDirection)) * unitDirection;
 }
 
 
+// Explicit counterpart of computeFaceGradient, cell gradients are taken from precomputed field
+// Warning ! Not for boundary faces
 template<class T>
+typename ProductType<T, Vector>::type evaluateFaceGradient
+(
+    MeshBase const& mesh,
+    Index faceIdx,
+    Field<T> const& field,
+    Field<typename ProductType<T, Vector>::type> const& cellGradient
+)
+{
+    using GradientType = ProductType<T, Vector>::type;
+
+    auto [ownerIdx, neighborIdx] = mesh.getFaceNeighbors(faceIdx);
+
+    Vector faceCentroid = mesh.getFaceCentroid(faceIdx);
+    Scalar ownerDistance = (faceCentroid - mesh.getCellCentroid(ownerIdx)).norm();
+    Scalar neighborDistance = (faceCentroid - mesh.getCellCentroid(neighborIdx)).norm();
+
+    Scalar ownerWeight = ownerDistance / (ownerDistance + neighborDistance);
+    Scalar neighborWeight = 1 - ownerWeight;
+
+    GradientType avgFaceGradient = ownerWeight * cellGradient(ownerIdx) + neighborWeight * cellGradient(neighborIdx);
+
+    if (!mesh.useNonOrthogonalCorrection)
+    {
+        return avgFaceGradient;
+    }
+
+    Vector unitDirection = Geometry::cellToCellUnitVectorAcrossFace(mesh, ownerIdx, faceIdx);
+    Scalar distanceBetweenCells = Geometry::distanceCellToCellAcrossFace(mesh, faceIdx);
+
+    T finiteDifference = (field(ownerIdx) - field(neighborIdx)) / distanceBetweenCells;
+    T directionalDerivative = innerProduct(avgFaceGradient, unitDirection);
+
+    return avgFaceGradient + outerProduct(T(finiteDifference - directionalDerivative), unitDirection);
+}
+
+
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Scalar> computeFaceNormalGradient
 (
     MeshBase const& mesh,
     Index cellFromIdx, 
     Index faceIdx,
-    BoundaryConditionGetter<T> const& boundaries
+    Getter const& boundaries
 )
 {
     if (mesh.isBoundaryFace(faceIdx))
@@ -128,7 +166,7 @@ LinearCombination<T, Scalar> computeFaceNormalGradient
         cellToIdx = tmpIdx1 + tmpIdx2 - cellFromIdx;
     }
 
-    Scalar distanceBetweenCells = Geometry::distanceCellToCell(mesh, cellFromIdx, cellToIdx);
+    Scalar distanceBetweenCells = Geometry::distanceCellToCellAcrossFace(mesh, faceIdx);
     LinearCombination<T, Scalar> finiteDifference = 
     {
         {1 / distanceBetweenCells, cellToIdx},
@@ -144,21 +182,21 @@ LinearCombination<T, Scalar> computeFaceNormalGradient
     auto gradientScheme = Schemes::Gradient::LEAST_SQAURE;
     auto avgFaceGradient = computeAverageFaceGradient(mesh, faceIdx, boundaries, gradientScheme);
 
-    Vector faceVector = mesh.getFaceVector(faceIdx).normalized();
+    Vector faceVector = mesh.getFaceUnitNormal(faceIdx);
     if (mesh.getFaceOwner(faceIdx) != cellFromIdx)
     {
         faceVector *= -1;
     }
 
     // Using over-relaxed approach
-    Vector unitDirection = Geometry::cellToCellUnitVector(mesh, cellFromIdx, cellToIdx);
-    Vector orthogonalComponent = faceVector.norm() / faceVector.dot(unitDirection) * unitDirection;
+    Vector unitDirection = Geometry::cellToCellUnitVectorAcrossFace(mesh, cellFromIdx, faceIdx);
+    Vector orthogonalComponent = 1 / faceVector.dot(unitDirection) * unitDirection;
     Vector nonOrthogonalComponent = faceVector - orthogonalComponent;
 
     return 
     (
-        finiteDifference * orthogonalComponent.norm() +
-        avgFaceGradient.dot(nonOrthogonalComponent)
+        lazy(finiteDifference) * orthogonalComponent.norm() +
+        lazy(avgFaceGradient).dot(nonOrthogonalComponent)
     );
 }
 
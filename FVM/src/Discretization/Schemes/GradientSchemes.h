@@ -3,6 +3,7 @@
 #include "Mesh/MeshBase.h"
 #include "Mesh/Geometry.h"
 #include "Discretization/LinearCombination.h"
+#include "Discretization/LinearExpression.h"
 #include "BasicInterpolation.h"
 
 #include <Eigen/LU>
@@ -11,12 +12,12 @@
 namespace Interpolation::Schemes::Gradient
 {
 
-template<class T>
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Vector> greenGauseGradientImpl
 (
     MeshBase const& mesh,
     Index cellIdx,
-    BoundaryConditionGetter<T> const& boundaries
+    Getter const& boundaries
 )
 {
     LinearCombination<T, Vector> gradient;
@@ -29,7 +30,7 @@ LinearCombination<T, Vector> greenGauseGradientImpl
             faceVector *= -1;
         }
         // Order of multiplication is important
-        gradient += valueOnFace(mesh, faceIdx, boundaries) * faceVector;
+        gradient += lazy(valueOnFace(mesh, faceIdx, boundaries)) * faceVector;
     }
     gradient /= mesh.getCellVolume(cellIdx);
 
@@ -37,12 +38,12 @@ LinearCombination<T, Vector> greenGauseGradientImpl
 }
 
 
-template<class T>
+template<class Getter, class T = BoundaryValueType<Getter>>
 LinearCombination<T, Vector> leastSquareGradientImpl
 (
     MeshBase const& mesh,
     Index cellIdx,
-    BoundaryConditionGetter<T> const& boundaries
+    Getter const& boundaries
 )
 {
     Tensor systemMatrix = Tensor::Zero();
@@ -70,7 +71,7 @@ LinearCombination<T, Vector> leastSquareGradientImpl
 
         Scalar weight = 1 / radiusVector.norm();
         systemMatrix += weight * outerProduct(radiusVector, radiusVector);
-        rhs += Vector(weight * radiusVector) * fieldChange;
+        rhs += Vector(weight * radiusVector) * lazy(fieldChange);
     }
 
     // For 2D case matrix is degenerate
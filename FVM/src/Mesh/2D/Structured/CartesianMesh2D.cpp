@@ -1,7 +1,7 @@
 #include "CartesianMesh2D.h"
 
 
-CartesianMesh2D::CartesianMesh2D(Index xSize, Index ySize, Scalar xLen, Scalar yLen) :
+CartesianMesh2D::CartesianMesh2D(Index xSize, Index ySize, Scalar xLen, Scalar yLen, bool boundaryFacesLast) :
     m_nx(xSize),
     m_ny(ySize)
 {
@@ -65,6 +65,35 @@ CartesianMesh2D::CartesianMesh2D(Index xSize, Index ySize, Scalar xLen, Scalar y
             }
         }
     }
+
+    if (boundaryFacesLast)
+    {
+        enum Patch {INTERIOR = -1, TOP, BOTTOM, LEFT, RIGHT};
+
+        List<Index> facePatches(totalFaces, INTERIOR);
+        for (Index faceIdx = 0; faceIdx < xSize; faceIdx++)
+        {
+            facePatches[faceIdx] = TOP;
+            facePatches[totalFaces-1 - faceIdx] = BOTTOM;
+        }
+        for (Index y = 0; y < ySize; y++)
+        {
+            facePatches[y*(2*xSize+1) + xSize] = LEFT;
+            facePatches[y*(2*xSize+1) + 2*xSize] = RIGHT;
+        }
+
+        m_faceRenumbering = renumberFaces(facePatches);
+    }
+
+    computeFaceGeometry();
+    computeFaceColors();
+    computeBoundaryTables();
+}
+
+
+Index CartesianMesh2D::faceIdxOf(Index structuredFaceIdx) const
+{
+    return m_faceRenumbering.empty() ? structuredFaceIdx : m_faceRenumbering[structuredFaceIdx];
 }
 
 
@@ -72,7 +101,7 @@ void CartesianMesh2D::setTopBoundary(Boundaries boundaries)
 {
     for (Index faceIdx = 0; faceIdx < m_nx; faceIdx++)
     {
-        m_boundariesMap[faceIdx] = boundaries;
+        setFaceBoundary(faceIdxOf(faceIdx), boundaries);
     }
 }
 
@@ -82,7 +111,7 @@ void CartesianMesh2D::setBottomBoundary(Boundaries boundaries)
     Index totalFaces = getFaceAmount();
     for (Index faceIdx = totalFaces-1; faceIdx >= totalFaces - m_nx; faceIdx--)
     {
-        m_boundariesMap[faceIdx] = boundaries;
+        setFaceBoundary(faceIdxOf(faceIdx), boundaries);
     }
 }
 
@@ -91,7 +120,7 @@ void CartesianMesh2D::setLeftBoundary(Boundaries boundaries)
 {
     for (Index faceIdx = m_nx; faceIdx < getFaceAmount(); faceIdx += 2*m_nx+1)
     {
-        m_boundariesMap[faceIdx] = boundaries;
+        setFaceBoundary(faceIdxOf(faceIdx), boundaries);
     }
 }   
 
@@ -100,7 +129,7 @@ void CartesianMesh2D::setRightBoundary(Boundaries boundaries)
 {
     for (Index faceIdx = 2*m_nx; faceIdx < getFaceAmount(); faceIdx += 2*m_nx+1)
     {
-        m_boundariesMap[faceIdx] = boundaries;
+        setFaceBoundary(faceIdxOf(faceIdx), boundaries);
     }
 }
 
@@ -108,3 +137,15 @@ bool CartesianMesh2D::is2D() const
 {
     return true;
 }
+
+
+Index CartesianMesh2D::getXSize() const
+{
+    return m_nx;
+}
+
+
+Index CartesianMesh2D::getYSize() const
+{
+    return m_ny;
+}
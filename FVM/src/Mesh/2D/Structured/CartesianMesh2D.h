@@ -8,7 +8,9 @@ class CartesianMesh2D : public MeshBase
 {
 public:
 
-    CartesianMesh2D(Index xSize, Index ySize, Scalar xLen, Scalar yLen);
+    // With boundaryFacesLast faces are renumbered: interior faces first,
+    // then top, bottom, left and right patches, solvers need it
+    CartesianMesh2D(Index xSize, Index ySize, Scalar xLen, Scalar yLen, bool boundaryFacesLast = false);
 
     //boundaries
     void setTopBoundary(Boundaries boundaries);
@@ -21,8 +23,19 @@ public:
 
     bool is2D() const override;
 
+    // Cells are numbered row by row, cell index is y*xSize + x
+    Index getXSize() const;
+    Index getYSize() const;
+
 protected:
 
     Index m_nx;
     Index m_ny;
+
+private:
+
+    // Structured face index to the actual one, empty if faces aren't renumbered
+    List<Index> m_faceRenumbering;
+
+    Index faceIdxOf(Index structuredFaceIdx) const;
 };
\ No newline at end of file
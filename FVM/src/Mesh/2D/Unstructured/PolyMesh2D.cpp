@@ -2,7 +2,7 @@
 #include "Parse.h"
 
 
-PolyMesh2D::PolyMesh2D(std::istream& stream)
+PolyMesh2D::PolyMesh2D(std::istream& stream, bool boundaryFacesLast)
 {
     List<Vector> vertices;
     List<Array<Index,2>> faces;
@@ -77,6 +77,71 @@ PolyMesh2D::PolyMesh2D(std::istream& stream)
             m_faceVectors[faceIdx] *= -1;
         }
     }
+
+    if (boundaryFacesLast)
+    {
+        renumberFaces(getFacePatches());
+    }
+
+    computeFaceGeometry();
+    computeFaceColors();
+    computeBoundaryTables();
+}
+
+
+List<Index> PolyMesh2D::getFacePatches() const
+{
+    auto equal = [](Boundaries const& lhs, Boundaries const& rhs)
+    {
+        return
+        (
+            lhs.uBoundary.type == rhs.uBoundary.type && lhs.uBoundary.value == rhs.uBoundary.value
+            && lhs.pBoundary.type == rhs.pBoundary.type && lhs.pBoundary.value == rhs.pBoundary.value
+        );
+    };
+
+    Index totalFaces = getFaceAmount();
+    List<Index> facePatches(totalFaces, -1);
+    List<Boundaries> patchBoundaries;
+    // Boundary faces without conditions form the separate patch
+    Index unsetPatch = -1;
+
+    for (Index faceIdx = 0; faceIdx < totalFaces; faceIdx++)
+    {
+        if (!isBoundaryFace(faceIdx))
+        {
+            continue;
+        }
+
+        auto iter = m_boundariesMap.find(faceIdx);
+        if (iter == m_boundariesMap.end())
+        {
+            if (-1 == unsetPatch)
+            {
+                unsetPatch = patchBoundaries.size();
+                patchBoundaries.push_back({});
+            }
+            facePatches[faceIdx] = unsetPatch;
+            continue;
+        }
+
+        Index patchIdx = 0;
+        while
+        (
+            patchIdx < static_cast<Index>(patchBoundaries.size())
+            && (patchIdx == unsetPatch || !equal(patchBoundaries[patchIdx], iter->second))
+        )
+        {
+            patchIdx++;
+        }
+        if (patchIdx == static_cast<Index>(patchBoundaries.size()))
+        {
+            patchBoundaries.push_back(iter->second);
+        }
+        facePatches[faceIdx] = patchIdx;
+    }
+
+    return facePatches;
 }
 
 
@@ -9,8 +9,15 @@ class PolyMesh2D : public MeshBase
 {
 public:
 
-    PolyMesh2D(std::istream& stream);
-    PolyMesh2D(std::istream&& stream) : PolyMesh2D(stream) {}
+    // With boundaryFacesLast faces are renumbered: interior faces first,
+    // then boundary faces grouped in patches of equal boundary conditions, solvers need it
+    PolyMesh2D(std::istream& stream, bool boundaryFacesLast = false);
+    PolyMesh2D(std::istream&& stream, bool boundaryFacesLast = false) : PolyMesh2D(stream, boundaryFacesLast) {}
 
     bool is2D() const override;
+
+private:
+
+    // Patch index of every face, -1 for interior faces
+    List<Index> getFacePatches() const;
 };
@@ -1,24 +1,24 @@
 #include "Geometry.h"
 
+#include <cassert>
+
 
 namespace Geometry
 {
 
 Scalar distanceCellToFace(MeshBase const& mesh, Index cellIdx, Index faceIdx)
 {
-    Vector normal = mesh.getFaceVector(faceIdx);
-    return distanceCellToFaceInDirection(mesh, cellIdx, faceIdx, normal);
+    auto [ownerIdx, neighborIdx] = mesh.getFaceNeighbors(faceIdx);
+    assert(cellIdx == ownerIdx || cellIdx == neighborIdx);
+
+    auto [ownerDistance, neighborDistance] = mesh.getFaceCellDistances(faceIdx);
+    return (cellIdx == ownerIdx ? ownerDistance : neighborDistance);
 }
 
 Scalar distanceCellToFaceInDirection(MeshBase const& mesh, Index cellIdx, Index faceIdx, Vector direction)
 {
     direction.normalize();
-    Vector cellCentroid = mesh.getCellCentroid(cellIdx);
-    Vector faceCentroid = mesh.getFaceCentroid(faceIdx);
-    Vector faceNormal = mesh.getFaceVector(faceIdx);
-
-    Scalar dist = abs(faceNormal.dot(faceCentroid) - faceNormal.dot(cellCentroid)) / faceNormal.dot(direction);
-    return dist;
+    return distanceCellToFace(mesh, cellIdx, faceIdx) / mesh.getFaceUnitNormal(faceIdx).dot(direction);
 }
 
 Scalar distanceCellToCell(MeshBase const& mesh, Index cellFromIdx, Index cellToIdx)
@@ -33,4 +33,19 @@ Vector cellToCellUnitVector(MeshBase const& mesh, Index cellFromIdx, Index cellT
     return radius.normalized();
 }
 
+Scalar distanceCellToCellAcrossFace(MeshBase const& mesh, Index faceIdx)
+{
+    return mesh.getFaceCellToCellDistance(faceIdx);
+}
+
+Vector cellToCellUnitVectorAcrossFace(MeshBase const& mesh, Index cellFromIdx, Index faceIdx)
+{
+    Vector unitDirection = mesh.getFaceCellToCellUnitVector(faceIdx);
+    if (cellFromIdx != mesh.getFaceOwner(faceIdx))
+    {
+        unitDirection *= -1;
+    }
+    return unitDirection;
+}
+
 } // namespace Geometry
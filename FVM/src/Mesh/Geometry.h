@@ -7,6 +7,7 @@
 namespace Geometry
 {
 
+// cellIdx should be one of the face neighbours
 Scalar distanceCellToFace(MeshBase const& mesh, Index cellIdx, Index faceIdx);
 
 Scalar distanceCellToFaceInDirection(MeshBase const& mesh, Index cellIdx, Index faceIdx, Vector direction);
@@ -15,4 +16,9 @@ Scalar distanceCellToCell(MeshBase const& mesh, Index cellFromIdx, Index cellToI
 
 Vector cellToCellUnitVector(MeshBase const& mesh, Index cellFromIdx, Index cellToIdx);
 
+// Same as above for the cells sharing the face, cellFromIdx should be one of the face neighbours
+Scalar distanceCellToCellAcrossFace(MeshBase const& mesh, Index faceIdx);
+
+Vector cellToCellUnitVectorAcrossFace(MeshBase const& mesh, Index cellFromIdx, Index faceIdx);
+
 } // namespace Geometry
@@ -1,5 +1,10 @@
 #include "MeshBase.h"
 
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+
 
 Index MeshBase::getCellAmount() const
 {
@@ -51,7 +56,11 @@ Vector MeshBase::getFaceVector(Index faceIdx) const
 
 Boundaries MeshBase::getFaceBoundary(Index faceIdx) const
 {
-    return m_boundariesMap.at(faceIdx);
+    if (!m_velocityBoundaries.contains(faceIdx))
+    {
+        throw std::out_of_range("No boundary condition for the face " + std::to_string(faceIdx));
+    }
+    return {m_velocityBoundaries(faceIdx), m_pressureBoundaries(faceIdx)};
 }
 
 
@@ -65,3 +74,267 @@ List<Index> const& MeshBase::getCellFaces(Index cellIdx) const
 {
     return m_cellFaces[cellIdx];
 }
+
+
+Scalar MeshBase::getFaceArea(Index faceIdx) const
+{
+    return m_faceAreas[faceIdx];
+}
+
+
+Vector MeshBase::getFaceUnitNormal(Index faceIdx) const
+{
+    return m_faceUnitNormals[faceIdx];
+}
+
+
+Array<Scalar, 2> MeshBase::getFaceCellDistances(Index faceIdx) const
+{
+    return m_faceCellDistances[faceIdx];
+}
+
+
+Scalar MeshBase::getFaceCellToCellDistance(Index faceIdx) const
+{
+    return m_faceCellToCellDistances[faceIdx];
+}
+
+
+Vector MeshBase::getFaceCellToCellUnitVector(Index faceIdx) const
+{
+    return m_faceCellToCellUnitVectors[faceIdx];
+}
+
+
+Scalar MeshBase::getFaceWeight(Index faceIdx) const
+{
+    return useNonOrthogonalCorrection ? m_faceNonOrthogonalWeights[faceIdx] : m_faceWeights[faceIdx];
+}
+
+
+BoundaryTable<Vector> const& MeshBase::getVelocityBoundaries() const
+{
+    return m_velocityBoundaries;
+}
+
+
+BoundaryTable<Scalar> const& MeshBase::getPressureBoundaries() const
+{
+    return m_pressureBoundaries;
+}
+
+
+List<List<Index>> const& MeshBase::getFaceColors() const
+{
+    return m_faceColors;
+}
+
+
+Index MeshBase::getDimension() const
+{
+    return is2D() ? 2 : 3;
+}
+
+
+bool MeshBase::isRenumbered() const
+{
+    return m_isRenumbered;
+}
+
+
+Index MeshBase::getInteriorFaceAmount() const
+{
+    return m_interiorFaceAmount;
+}
+
+
+List<Array<Index,2>> const& MeshBase::getBoundaryPatches() const
+{
+    return m_boundaryPatches;
+}
+
+
+List<Index> MeshBase::renumberFaces(List<Index> const& facePatches)
+{
+    Index totalFaces = getFaceAmount();
+    Index totalPatches = 1 + *std::max_element(facePatches.begin(), facePatches.end());
+
+    // Interior faces first, then boundary faces patch by patch, keeping the original order inside groups
+    // Counting sort, group 0 is interior faces and group (p+1) is patch p
+    List<Index> groupStarts(totalPatches + 2, 0);
+    for (Index patchIdx : facePatches)
+    {
+        groupStarts[patchIdx + 2]++;
+    }
+    for (Index groupIdx = 1; groupIdx < totalPatches + 2; groupIdx++)
+    {
+        groupStarts[groupIdx] += groupStarts[groupIdx - 1];
+    }
+
+    m_interiorFaceAmount = groupStarts[1];
+    m_boundaryPatches.clear();
+    for (Index patchIdx = 0; patchIdx < totalPatches; patchIdx++)
+    {
+        m_boundaryPatches.push_back({groupStarts[patchIdx + 1], groupStarts[patchIdx + 2]});
+    }
+
+    List<Index> newFaceIdx(totalFaces);
+    for (Index faceIdx = 0; faceIdx < totalFaces; faceIdx++)
+    {
+        newFaceIdx[faceIdx] = groupStarts[facePatches[faceIdx] + 1]++;
+    }
+
+    auto permute = [&](auto& faceArray)
+    {
+        auto copy = faceArray;
+        for (Index faceIdx = 0; faceIdx < totalFaces; faceIdx++)
+        {
+            faceArray[newFaceIdx[faceIdx]] = copy[faceIdx];
+        }
+    };
+    permute(m_faceVectors);
+    permute(m_faceCentroids);
+    permute(m_faceNeighbors);
+
+    for (auto& cellFaces : m_cellFaces)
+    {
+        for (Index& faceIdx : cellFaces)
+        {
+            faceIdx = newFaceIdx[faceIdx];
+        }
+    }
+
+    HashMap<Index, Boundaries> boundariesMap;
+    for (auto const& [faceIdx, boundaries] : m_boundariesMap)
+    {
+        boundariesMap[newFaceIdx[faceIdx]] = boundaries;
+    }
+    m_boundariesMap = std::move(boundariesMap);
+
+    m_isRenumbered = true;
+    return newFaceIdx;
+}
+
+
+void MeshBase::setFaceBoundary(Index faceIdx, Boundaries const& boundaries)
+{
+    m_boundariesMap[faceIdx] = boundaries;
+    m_velocityBoundaries.set(faceIdx, boundaries.uBoundary);
+    m_pressureBoundaries.set(faceIdx, boundaries.pBoundary);
+}
+
+
+void MeshBase::computeFaceGeometry()
+{
+    Index totalFaces = getFaceAmount();
+
+    m_faceAreas.resize(totalFaces);
+    m_faceUnitNormals.resize(totalFaces);
+    m_faceCellDistances.resize(totalFaces);
+    m_faceCellToCellDistances.resize(totalFaces);
+    m_faceCellToCellUnitVectors.resize(totalFaces);
+    m_faceWeights.resize(totalFaces);
+    m_faceNonOrthogonalWeights.resize(totalFaces);
+
+    m_interiorFaceAmount = 0;
+    for (Index faceIdx = 0; faceIdx < totalFaces; faceIdx++)
+    {
+        auto [ownerIdx, neighborIdx] = m_faceNeighbors[faceIdx];
+        Vector faceCentroid = m_faceCentroids[faceIdx];
+        m_interiorFaceAmount += (-1 != neighborIdx);
+
+        m_faceAreas[faceIdx] = m_faceVectors[faceIdx].norm();
+        Vector unitNormal = m_faceVectors[faceIdx] / m_faceAreas[faceIdx];
+        m_faceUnitNormals[faceIdx] = unitNormal;
+
+        auto normalDistance = [&](Index cellIdx)
+        {
+            return std::abs(unitNormal.dot(faceCentroid - m_cellCentroids[cellIdx]));
+        };
+
+        Scalar ownerDistance = normalDistance(ownerIdx);
+
+        if (-1 == neighborIdx)
+        {
+            m_faceCellDistances[faceIdx] = {ownerDistance, 0};
+            m_faceCellToCellDistances[faceIdx] = ownerDistance;
+            m_faceCellToCellUnitVectors[faceIdx] = unitNormal;
+            m_faceWeights[faceIdx] = 1;
+            m_faceNonOrthogonalWeights[faceIdx] = 1;
+            continue;
+        }
+
+        Scalar neighborDistance = normalDistance(neighborIdx);
+        Vector radius = m_cellCentroids[neighborIdx] - m_cellCentroids[ownerIdx];
+        Scalar radiusNorm = radius.norm();
+        Vector unitDirection = radius / radiusNorm;
+
+        m_faceCellDistances[faceIdx] = {ownerDistance, neighborDistance};
+        m_faceCellToCellDistances[faceIdx] = radiusNorm;
+        m_faceCellToCellUnitVectors[faceIdx] = unitDirection;
+
+        m_faceWeights[faceIdx] = 1 - ownerDistance / (ownerDistance + neighborDistance);
+        // distance from the owner to the face along the line connecting the centroids
+        m_faceNonOrthogonalWeights[faceIdx] = ownerDistance / unitNormal.dot(unitDirection) / radiusNorm;
+    }
+}
+
+
+void MeshBase::computeFaceColors()
+{
+    Index totalFaces = getFaceAmount();
+    // Boundary patches of the renumbered mesh are looped as ranges
+    Index coloredFaces = (m_isRenumbered ? m_interiorFaceAmount : totalFaces);
+    List<Index> faceColor(totalFaces, -1);
+    List<bool> isColorUsed;
+
+    // Greedy coloring, each face gets the smallest color not used by the faces of its cells
+    for (Index faceIdx = 0; faceIdx < coloredFaces; faceIdx++)
+    {
+        std::fill(isColorUsed.begin(), isColorUsed.end(), false);
+
+        for (Index cellIdx : m_faceNeighbors[faceIdx])
+        {
+            if (-1 == cellIdx)
+            {
+                continue;
+            }
+            for (Index adjacentFaceIdx : m_cellFaces[cellIdx])
+            {
+                if (-1 != faceColor[adjacentFaceIdx])
+                {
+                    isColorUsed[faceColor[adjacentFaceIdx]] = true;
+                }
+            }
+        }
+
+        Index color = std::find(isColorUsed.begin(), isColorUsed.end(), false) - isColorUsed.begin();
+        if (color == static_cast<Index>(isColorUsed.size()))
+        {
+            isColorUsed.push_back(false);
+            m_faceColors.emplace_back();
+        }
+
+        faceColor[faceIdx] = color;
+        m_faceColors[color].push_back(faceIdx);
+    }
+}
+
+
+void MeshBase::computeBoundaryTables()
+{
+    Index totalFaces = getFaceAmount();
+    m_velocityBoundaries = BoundaryTable<Vector>(totalFaces);
+    m_pressureBoundaries = BoundaryTable<Scalar>(totalFaces);
+
+    // Ordered by face index, so neighbouring boundary faces are close in memory
+    for (Index faceIdx = 0; faceIdx < totalFaces; faceIdx++)
+    {
+        auto iter = m_boundariesMap.find(faceIdx);
+        if (iter != m_boundariesMap.end())
+        {
+            m_velocityBoundaries.set(faceIdx, iter->second.uBoundary);
+            m_pressureBoundaries.set(faceIdx, iter->second.pBoundary);
+        }
+    }
+}
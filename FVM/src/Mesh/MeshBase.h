@@ -2,6 +2,7 @@
 
 #include "Utils/Types.h"
 #include "Boundary/BoundaryCondition.h"
+#include "Boundary/BoundaryTable.h"
 
 
 class MeshBase
@@ -32,11 +33,47 @@ public:
 
     List<Index> const&  getCellFaces(Index cellIdx) const;
 
+    // precomputed face geometry
+    Scalar              getFaceArea(Index faceIdx) const;
+
+    Vector              getFaceUnitNormal(Index faceIdx) const;
+
+    // distances from the owner and the neighbour centroids to the face along the face normal
+    Array<Scalar, 2>    getFaceCellDistances(Index faceIdx) const;
+
+    // distance and unit vector from the owner centroid to the neighbour centroid
+    Scalar              getFaceCellToCellDistance(Index faceIdx) const;
+
+    Vector              getFaceCellToCellUnitVector(Index faceIdx) const;
+
+    // interpolation weight of the owner cell, the neighbour weight is 1 - weight
+    Scalar              getFaceWeight(Index faceIdx) const;
+
+    // dense boundary conditions, cheap to call from face kernels
+    BoundaryTable<Vector> const& getVelocityBoundaries() const;
+
+    BoundaryTable<Scalar> const& getPressureBoundaries() const;
+
+    // groups of faces, faces in the same group don't share cells,
+    // only interior faces are grouped if faces are renumbered
+    List<List<Index>> const& getFaceColors() const;
+
+    // if faces are renumbered, interior faces are [0, getInteriorFaceAmount())
+    // and boundary faces follow as contiguous [begin, end) ranges per patch
+    bool                isRenumbered() const;
+
+    Index               getInteriorFaceAmount() const;
+
+    List<Array<Index,2>> const& getBoundaryPatches() const;
+
 
     bool useNonOrthogonalCorrection = false;
 
     virtual bool is2D() const = 0;
 
+    // amount of active components of vectors, z component is always zero in 2D
+    Index getDimension() const;
+
     virtual ~MeshBase() = default;
 
 protected:
@@ -49,4 +86,35 @@ protected:
     List<Array<Index,2>> m_faceNeighbors;
 
     HashMap<Index, Boundaries> m_boundariesMap;
+
+    // facePatches holds patch index for boundary faces and -1 for interior faces,
+    // should be called before computing geometry, returns new index of each face
+    List<Index> renumberFaces(List<Index> const& facePatches);
+
+    // keeps the map and the boundary tables consistent
+    void setFaceBoundary(Index faceIdx, Boundaries const& boundaries);
+
+    // should be called by the derived class after the arrays above are filled
+    void computeFaceGeometry();
+    void computeFaceColors();
+    void computeBoundaryTables();
+
+private:
+
+    List<Scalar>          m_faceAreas;
+    List<Vector>          m_faceUnitNormals;
+    List<Array<Scalar,2>> m_faceCellDistances;
+    List<Scalar>          m_faceCellToCellDistances;
+    List<Vector>          m_faceCellToCellUnitVectors;
+    List<Scalar>          m_faceWeights;
+    List<Scalar>          m_faceNonOrthogonalWeights;
+
+    List<List<Index>>     m_faceColors;
+
+    BoundaryTable<Vector> m_velocityBoundaries;
+    BoundaryTable<Scalar> m_pressureBoundaries;
+
+    Index                 m_interiorFaceAmount = 0;
+    bool                  m_isRenumbered = false;
+    List<Array<Index,2>>  m_boundaryPatches;
 };
@@ -0,0 +1,341 @@
+#include "CoupledAlgorithm.h"
+#include "Discretization/Interpolation.h"
+#include "Config/Config.h"
+#include "Utils/LinearSolvers/Preconditioners.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+
+CoupledAlgorithm::CoupledAlgorithm(MeshBase const& mesh)
+    : SolverBase(mesh)
+    , gradientScheme(Config::gradientScheme)
+    , convectionScheme(Config::convectionScheme)
+{}
+
+
+void CoupledAlgorithm::solve()
+{
+    initFields();
+
+    if (isTransient())
+    {
+        if (m_timeStep == 0)
+        {
+            throw std::runtime_error("Time Step should be non zero value\n");
+        }
+        storeTimePoint(Config::timeBegin, m_currentVelocity, m_currentPressure);
+    }
+
+    // Coupled loop
+    m_timers["total"].start();
+    m_currTime = Config::timeBegin;
+    do
+    {
+        m_currTime += m_timeStep;
+        m_velocityResidual = std::numeric_limits<Scalar>::max();
+        m_pressureResidual = std::numeric_limits<Scalar>::max();
+
+        for (m_currIterationIdx = 1; m_currIterationIdx <= Config::maxIterations && !(converged() || diverged()); m_currIterationIdx++)
+        {
+            m_timers["generating linear systems"].start();
+            generateCoupledSystem();
+            m_timers["generating linear systems"].stop();
+
+            solveCoupledSystem();
+            computePressureGradient();
+            computeMassFluxes();
+
+            printIterationInfo();
+        }
+
+        printTimePointInfo();
+
+        storeTimePoint(m_currTime, m_currentVelocity, m_currentPressure);
+
+        if (diverged())
+        {
+            break;
+        }
+    }
+    while (isTransient() && m_currTime <= Config::timeEnd);
+
+
+    m_converged = converged();
+
+    m_timers["total"].stop();
+
+    printTimers();
+}
+
+
+void CoupledAlgorithm::initFields()
+{
+    initFlowFields();
+
+    Index totalCells = m_mesh.getCellAmount();
+    m_systemMatrix = SparseMatrix(totalCells * blockSize(), totalCells * blockSize());
+    m_systemSource = Matrix(totalCells * blockSize(), 1);
+
+    m_systemSolver = LinearSolver(LinearSolvers::Solver::GMRES, std::make_unique<BlockILU0Preconditioner>(blockSize()));
+    m_systemSolver.setRefreshThreshold(Config::preconditionerRefreshThreshold);
+    m_systemSolver.setSparseFormat(Config::sparseFormat);
+    m_systemSolver.setMaxIterations(Config::maxSystemIterations);
+    // Outer iterations start from the previous solution, so only the reduction of its residual matters
+    m_systemSolver.setInitialResidualTolerance(true);
+    resetLinearSolveRecords(Config::linearSolverLog);
+
+    m_pressureGradientOperator = GradientOperator<Scalar>(m_mesh, m_mesh.getPressureBoundaries(), gradientScheme);
+    computePressureGradient();
+}
+
+
+void CoupledAlgorithm::generateCoupledSystem()
+{
+    using Triplet = Eigen::Triplet<Scalar>;
+
+    Index totalCells = m_mesh.getCellAmount();
+    Index dimension = m_mesh.getDimension();
+    Index size = blockSize();
+    auto const& uBoundaries = m_mesh.getVelocityBoundaries();
+    auto const& pBoundaries = m_mesh.getPressureBoundaries();
+
+    auto momentumFluxGetter = [&](Index faceIdx)
+    {
+        LinearCombination<Vector> uFlux = Interpolation::computeConvectionFluxOverFace
+        (
+            m_mesh, faceIdx, uBoundaries, m_massFluxes, convectionScheme
+        );
+        uFlux -= Config::viscosity * Interpolation::computeDiffusionFluxOverFace(m_mesh, faceIdx, uBoundaries);
+
+        return uFlux;
+    };
+
+    // Momentum without pressure, V/A for Rhie-Chow interpolation is known only after it
+    List<LinearCombination<Vector>> momentum(totalCells);
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index cellIdx = 0; cellIdx < totalCells; cellIdx++)
+    {
+        Scalar cellVolume = m_mesh.getCellVolume(cellIdx);
+        LinearCombination<Vector> uEqn = Interpolation::sumFluxesOverCell<Vector>(m_mesh, cellIdx, momentumFluxGetter);
+
+        if (isTransient())
+        {
+            uEqn += transientTerm(cellIdx);
+        }
+
+        Scalar diagonal = 0;
+        for (auto [coeff, varIdx] : uEqn.terms)
+        {
+            if (varIdx == cellIdx)
+            {
+                diagonal += coeff;
+            }
+        }
+
+        // Implicit under relaxation, pressure is not relaxed
+        Scalar relaxedPart = (1 / Config::coupledURelax - 1) * diagonal;
+        uEqn += Term<Scalar>{relaxedPart, cellIdx};
+        uEqn -= Vector(relaxedPart * m_currentVelocity(cellIdx));
+
+        m_VbyA(cellIdx) = cellVolume * Config::coupledURelax / diagonal;
+        momentum[cellIdx] = std::move(uEqn);
+    }
+
+    List<List<Triplet>> cellTriplets(totalCells);
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index cellIdx = 0; cellIdx < totalCells; cellIdx++)
+    {
+        List<Triplet>& triplets = cellTriplets[cellIdx];
+        Index pressureRow = cellIdx * size + dimension;
+
+        for (auto [coeff, varIdx] : momentum[cellIdx].terms)
+        {
+            for (Index component = 0; component < dimension; component++)
+            {
+                triplets.emplace_back(cellIdx * size + component, varIdx * size + component, coeff);
+            }
+        }
+        for (Index component = 0; component < dimension; component++)
+        {
+            m_systemSource(cellIdx * size + component) = -momentum[cellIdx].bias(component);
+        }
+        m_systemSource(pressureRow) = 0;
+
+        for (Index faceIdx : m_mesh.getCellFaces(cellIdx))
+        {
+            Scalar sign = (m_mesh.getFaceOwner(faceIdx) == cellIdx ? 1 : -1);
+            Vector faceVector = sign * m_mesh.getFaceVector(faceIdx);
+
+            // Pressure force, as Green-Gauss gradient
+            LinearCombination<Scalar> facePressure = Interpolation::valueOnFace(m_mesh, faceIdx, pBoundaries);
+            for (auto [coeff, varIdx] : facePressure.terms)
+            {
+                for (Index component = 0; component < dimension; component++)
+                {
+                    triplets.emplace_back(cellIdx * size + component, varIdx * size + dimension, coeff * faceVector(component));
+                }
+            }
+            for (Index component = 0; component < dimension; component++)
+            {
+                m_systemSource(cellIdx * size + component) -= facePressure.bias * faceVector(component);
+            }
+
+            // Continuity, mass flux outwards the cell
+            LinearCombination<Vector> faceVelocity = Interpolation::valueOnFace(m_mesh, faceIdx, uBoundaries);
+            for (auto [coeff, varIdx] : faceVelocity.terms)
+            {
+                for (Index component = 0; component < dimension; component++)
+                {
+                    triplets.emplace_back(pressureRow, varIdx * size + component, Config::density * coeff * faceVector(component));
+                }
+            }
+            m_systemSource(pressureRow) -= Config::density * faceVelocity.bias.dot(faceVector);
+
+            // Same as computeRhieChowVelocityOnFace, but pressure on the face is implicit
+            if (m_mesh.isBoundaryFace(faceIdx))
+            {
+                continue;
+            }
+
+            Scalar VbyAf = Interpolation::valueOnFace(m_mesh, faceIdx, zeroGradGetter<Scalar>()).evaluate(m_VbyA);
+            Vector avgFaceGradient = Interpolation::valueOnFace(m_mesh, faceIdx, zeroGradGetter<Vector>()).evaluate(m_pressureGradient);
+            LinearCombination<Scalar> faceNormalGradient = Interpolation::computeFaceNormalGradient(m_mesh, cellIdx, faceIdx, pBoundaries);
+
+            Scalar diffusionCoeff = Config::density * VbyAf * m_mesh.getFaceArea(faceIdx);
+            for (auto [coeff, varIdx] : faceNormalGradient.terms)
+            {
+                triplets.emplace_back(pressureRow, varIdx * size + dimension, -diffusionCoeff * coeff);
+            }
+            m_systemSource(pressureRow) += diffusionCoeff * faceNormalGradient.bias;
+            m_systemSource(pressureRow) -= Config::density * VbyAf * avgFaceGradient.dot(faceVector);
+        }
+    }
+
+    Index totalTriplets = 0;
+    for (List<Triplet> const& triplets : cellTriplets)
+    {
+        totalTriplets += triplets.size();
+    }
+
+    List<Triplet> triplets;
+    triplets.reserve(totalTriplets);
+    for (List<Triplet> const& cellPart : cellTriplets)
+    {
+        triplets.insert(triplets.end(), cellPart.begin(), cellPart.end());
+    }
+
+    m_systemMatrix = SparseMatrix(totalCells * size, totalCells * size);
+    m_systemMatrix.setFromTriplets(triplets.begin(), triplets.end());
+    m_systemMatrix.makeCompressed();
+}
+
+
+void CoupledAlgorithm::solveCoupledSystem()
+{
+    Index totalCells = m_mesh.getCellAmount();
+    Index dimension = m_mesh.getDimension();
+    Index size = blockSize();
+
+    m_timers["solving linear systems"].start();
+    Matrix guess(totalCells * size, 1);
+    for (Index cellIdx = 0; cellIdx < totalCells; cellIdx++)
+    {
+        guess.block(cellIdx * size, 0, dimension, 1) = m_currentVelocity(cellIdx).head(dimension);
+        guess(cellIdx * size + dimension) = m_currentPressure(cellIdx);
+    }
+
+    Matrix solution = m_systemSolver.solve(m_systemMatrix, m_systemSource, guess, Config::coupledSystemTolerance);
+    recordLinearSolve("coupled", m_currTime, m_currIterationIdx, m_systemSolver.getRecord());
+    m_timers["solving linear systems"].stop();
+
+    // Residuals are relative changes of the fields, as in SIMPLE
+    m_timers["computing residuals"].start();
+    Scalar velocityChange = 0, velocityMax = 0;
+    Scalar pressureChange = 0, pressureMax = 0;
+    for (Index cellIdx = 0; cellIdx < totalCells; cellIdx++)
+    {
+        Vector velocity = Vector::Zero();
+        velocity.head(dimension) = solution.block(cellIdx * size, 0, dimension, 1);
+        Scalar pressure = solution(cellIdx * size + dimension);
+
+        velocityChange = std::max(velocityChange, (velocity - m_currentVelocity(cellIdx)).cwiseAbs().maxCoeff());
+        velocityMax = std::max(velocityMax, velocity.cwiseAbs().maxCoeff());
+        pressureChange = std::max(pressureChange, std::abs(pressure - m_currentPressure(cellIdx)));
+        pressureMax = std::max(pressureMax, std::abs(pressure));
+
+        m_currentVelocity(cellIdx) = velocity;
+        m_currentPressure(cellIdx) = pressure;
+    }
+
+    // Fields at rest have nothing to be relative to
+    m_velocityResidual = (velocityMax > 0 ? velocityChange / velocityMax : velocityChange);
+    m_pressureResidual = (pressureMax > 0 ? pressureChange / pressureMax : pressureChange);
+    m_timers["computing residuals"].stop();
+}
+
+
+Index CoupledAlgorithm::blockSize() const
+{
+    // Velocity components and pressure
+    return m_mesh.getDimension() + 1;
+}
+
+
+bool CoupledAlgorithm::converged() const
+{
+    return
+    (
+        m_velocityResidual < Config::uTolerance
+        && m_pressureResidual < Config::pTolerance
+    );
+}
+
+
+bool CoupledAlgorithm::diverged() const
+{
+    return
+    (
+        std::isnan(m_velocityResidual) || std::isnan(m_pressureResidual)
+    );
+}
+
+
+void CoupledAlgorithm::printIterationInfo() const
+{
+    if (isTransient())
+    {
+        return;
+    }
+
+    std::cout << "Iteration #" << m_currIterationIdx <<
+        "\n\tVelocity residual : " << m_velocityResidual <<
+        "\n\tPressure residual : " << m_pressureResidual <<
+        "\n\tCoupled solver : " << m_systemSolver.iterations() << " iterations, residual " << m_systemSolver.getRecord().error <<
+        "\n\n";
+}
+
+
+void CoupledAlgorithm::printTimePointInfo() const
+{
+    if (!isTransient())
+    {
+        return;
+    }
+
+    std::cout << "Time Point: " << m_currTime <<
+        "\n\tTotal iterations: " << m_currIterationIdx <<
+        "\n\tVelocity residual: " << m_velocityResidual <<
+        "\n\tPressure residual: " << m_pressureResidual <<
+        "\n\tCoupled solver: " << m_systemSolver.iterations() << " iterations, residual " << m_systemSolver.getRecord().error <<
+        "\n\n";
+}
+
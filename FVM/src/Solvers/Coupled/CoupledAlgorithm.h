@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Utils/Types.h"
+#include "Mesh/MeshBase.h"
+#include "Solvers/SolverBase.h"
+#include "Discretization/Schemes/InterpolationSchemes.h"
+#include "Utils/LinearSolvers/LinearSolver.h"
+
+
+// Momentum and continuity with Rhie-Chow face velocities are solved as one system.
+// Unknowns of a cell are stored together, so the matrix consists of
+// (dimension + 1) x (dimension + 1) blocks and is solved by GMRES with block ILU0.
+// Convection is linearized with mass fluxes of the previous outer iteration
+class CoupledAlgorithm : public SolverBase
+{
+public:
+
+    CoupledAlgorithm(MeshBase const& mesh);
+
+    void solve() override;
+
+    // Schemes
+    Interpolation::Schemes::Gradient::Type gradientScheme;
+    Interpolation::Schemes::Convection::Type convectionScheme;
+
+private:
+
+    // Velocity components and pressure of each cell in a row
+    SparseMatrix m_systemMatrix;
+    Matrix m_systemSource;
+    LinearSolver m_systemSolver;
+
+    Scalar m_velocityResidual;
+    Scalar m_pressureResidual;
+
+
+    void initFields();
+    void generateCoupledSystem();
+    void solveCoupledSystem();
+
+    Index blockSize() const;
+
+    bool converged() const;
+    bool diverged() const;
+
+    void printIterationInfo() const;
+    void printTimePointInfo() const;
+};
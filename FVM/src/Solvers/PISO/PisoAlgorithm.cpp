@@ -0,0 +1,135 @@
+#include "PisoAlgorithm.h"
+#include "Config/Config.h"
+#include <iostream>
+#include <stdexcept>
+
+
+PisoAlgorithm::PisoAlgorithm(MeshBase const& mesh)
+    : SegregatedSolver(mesh)
+    , correctorAmount(Config::pisoCorrectors)
+{
+    setTransient(true);
+}
+
+
+void PisoAlgorithm::solve()
+{
+    if (!isTransient())
+    {
+        throw std::runtime_error("PISO is a transient algorithm\n");
+    }
+    if (Config::timeStep == 0)
+    {
+        throw std::runtime_error("Time Step should be non zero value\n");
+    }
+    if (correctorAmount < 1)
+    {
+        throw std::runtime_error("PISO needs at least one pressure corrector\n");
+    }
+
+    initFields();
+
+    storeTimePoint(Config::timeBegin, m_currentVelocity, m_currentPressure);
+
+    // PISO loop
+    m_timers["total"].start();
+    m_currTime = Config::timeBegin;
+    do
+    {
+        m_currTime += m_timeStep;
+
+        m_currIterationIdx = 1;
+        computePressureGradient();
+        predictMomentum();
+
+        for (; m_currIterationIdx <= correctorAmount; m_currIterationIdx++)
+        {
+            if (m_currIterationIdx > 1)
+            {
+                correctNeighbourVelocities();
+            }
+            computeMassFluxes();
+            correctPressure();
+            computePressureGradient();
+        }
+
+        printTimePointInfo();
+
+        storeTimePoint(m_currTime, m_currentVelocity, m_currentPressure);
+
+        if (diverged())
+        {
+            break;
+        }
+    }
+    while (m_currTime <= Config::timeEnd);
+
+
+    m_converged = !diverged();
+
+    m_timers["total"].stop();
+
+    printTimers();
+}
+
+
+bool PisoAlgorithm::diverged() const
+{
+    // Pressure correction can vanish at rest, so fields are checked instead of the residual
+    return !m_currentPressure.allFinite();
+}
+
+
+void PisoAlgorithm::printTimePointInfo() const
+{
+    std::cout << "Time Point: " << m_currTime <<
+        "\n\tPressure residual: " << m_pressureResidual <<
+        "\n\tMomentum solver: " << m_momentumSolver.iterations() << " iterations, residual " << m_momentumSolver.getRecord().error <<
+        "\n\tPressure solver: " << m_pressureSolver.iterations() << " iterations, residual " << m_pressureSolver.getRecord().error <<
+        "\n\n";
+}
+
+
+void PisoAlgorithm::predictMomentum()
+{
+    // Time step limits the change of velocity instead of relaxation
+    solveMomentum(1);
+
+    m_timers["explicit field computation"].start();
+    Index dimension = m_mesh.getDimension();
+    m_momentumSourceWithoutPressure = m_momentumSystemSource.leftCols(dimension);
+    for (Index cellIdx = 0; cellIdx < m_mesh.getCellAmount(); cellIdx++)
+    {
+        Vector pressureGradient = m_pressureGradient(cellIdx) * m_mesh.getCellVolume(cellIdx);
+        m_momentumSourceWithoutPressure.row(cellIdx) += pressureGradient.head(dimension).transpose();
+    }
+    m_timers["explicit field computation"].stop();
+}
+
+
+void PisoAlgorithm::correctNeighbourVelocities()
+{
+    m_timers["explicit field computation"].start();
+    Index dimension = m_mesh.getDimension();
+    Field<Scalar> diagonal = m_momentumSystemMatrix.diagonal();
+
+    Matrix residual = m_momentumSourceWithoutPressure - m_momentumSystemMatrix * velocityColumns();
+    for (Index cellIdx = 0; cellIdx < m_mesh.getCellAmount(); cellIdx++)
+    {
+        Vector pressureGradient = m_pressureGradient(cellIdx) * m_mesh.getCellVolume(cellIdx);
+        residual.row(cellIdx) -= pressureGradient.head(dimension).transpose();
+
+        m_currentVelocity(cellIdx).head(dimension) += residual.row(cellIdx).transpose() / diagonal(cellIdx);
+    }
+    m_timers["explicit field computation"].stop();
+}
+
+
+void PisoAlgorithm::correctPressure()
+{
+    Field<Scalar> pCorrection = solvePressureCorrection();
+
+    m_pressureResidual = relativeResidual(m_currentPressure, pCorrection);
+
+    applyPressureCorrection(pCorrection);
+}
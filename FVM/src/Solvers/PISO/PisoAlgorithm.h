@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Utils/Types.h"
+#include "Mesh/MeshBase.h"
+#include "Solvers/SegregatedSolver.h"
+
+
+// Transient solver, one momentum predictor and a few pressure correctors per time step
+// without under relaxation. Momentum matrix is frozen within the time step,
+// later correctors restore neighbour velocity corrections SIMPLE neglects
+class PisoAlgorithm : public SegregatedSolver
+{
+public:
+
+    PisoAlgorithm(MeshBase const& mesh);
+
+    void solve() override;
+
+    Index correctorAmount;
+
+private:
+
+    // Momentum rhs of the predictor without pressure gradient
+    Matrix m_momentumSourceWithoutPressure;
+
+    Scalar m_pressureResidual;
+
+
+    void predictMomentum();
+    // Jacobi sweep of the momentum system with the corrected pressure gradient
+    void correctNeighbourVelocities();
+    void correctPressure();
+
+    bool diverged() const;
+
+    void printTimePointInfo() const;
+};
@@ -1,13 +1,13 @@
 #pragma once
 
 #include "Utils/Types.h"
-#include "Utils/Timer.h"
 #include "Mesh/MeshBase.h"
-#include "Solvers/SolverBase.h"
-#include "Discretization/Schemes/InterpolationSchemes.h"
+#include "Solvers/SegregatedSolver.h"
+#include "Utils/LinearSolvers/ForcingTerm.h"
+#include "Solvers/TimeStepController.h"
 
 
-class SimpleAlgorithm : public SolverBase
+class SimpleAlgorithm : public SegregatedSolver
 {
 public:
 
@@ -15,38 +15,31 @@ public:
 
     void solve() override;
 
-    // Schemes
-    Interpolation::Schemes::Gradient::Type gradientScheme;
-    Interpolation::Schemes::Convection::Type convectionScheme;
+    // Inexact inner solves, tolerances follow the pressure residual
+    bool adaptiveSystemTolerance;
+    // SIMPLEC, pressure correction is consistent with velocity one and isn't relaxed
+    bool simplec;
+    // Transient time step follows the target Courant number, Config::timeStep is the first one
+    bool adaptiveTimeStep;
 
-private:
-
-    // Fields in the current iteration
-    Field<Vector> m_currentVelocity;
-    Field<Scalar> m_currentPressure;
-    Field<Vector> m_pressureGradient;
-    Field<Scalar> m_VbyA;
-    Field<Scalar> m_massFluxes;
+    // Every time step taken, empty for steady solve
+    List<TimeStepRecord> const& getTimeStepHistory() const;
 
-    // Momentum matrix and rhs
-    SparseMatrix m_momentumSystemMatrix;
-    Matrix m_momentumSystemSource;
-
-    // Pressure correction matrix and rhs
-    SparseMatrix m_pressureSystemMatrix;
-    Matrix m_pressureSystemSource;
+private:
 
-    HashMap<std::string, Timer> m_timers;
+    // Inner tolerances of the current iteration.
+    // Convergence is judged by the pressure correction, so its solve is kept
+    // tighter, otherwise loose solves give small corrections and false convergence
+    ForcingTerm m_momentumForcingTerm = ForcingTerm(0.1, 0.1);
+    ForcingTerm m_pressureForcingTerm = ForcingTerm(0.01, 0.01);
 
-    Index m_currIterationIdx;
-    Scalar m_currTime;
     Scalar m_pressureResidual;
 
+    List<TimeStepRecord> m_timeStepHistory;
 
-    void initFields();
-    void computePressureGradient();
-    void solveMomentum();
-    void computeMassFluxes();
+
+    void initFields() override;
+    void updateSystemTolerances();
     void correctPressure();
 
     bool converged() const;
@@ -54,16 +47,4 @@ private:
 
     void printIterationInfo() const;
     void printTimePointInfo() const;
-
-    void generateMomentumSystem();
-    void generatePressureCorrectionSystem();
-    void computeVbyA();
-    Field<Vector> getVelocityCorrection(Field<Scalar> const& pCorrection);
-    Field<Scalar> getMassFluxesCorrection(Field<Scalar> const& pCorrection);
-
-    Scalar relativeResidual(Matrix const& field, Matrix const& correction);
-
-    BoundaryConditionGetter<Vector> getVelocityBoundaries();
-    BoundaryConditionGetter<Scalar> getPressureBoundaries();
-    BoundaryConditionGetter<Scalar> getPressureCorrectionBoundaries();
 };
@@ -0,0 +1,649 @@
+#include "SegregatedSolver.h"
+#include "Discretization/Interpolation.h"
+#include "Config/Config.h"
+#include "Utils/MatrixSolver.h"
+#include "Utils/LinearSolvers/GeometricMultigrid.h"
+#include "Mesh/2D/Structured/CartesianMesh2D.h"
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+SegregatedSolver::SegregatedSolver(MeshBase const& mesh) 
+    : SolverBase(mesh)
+    , gradientScheme(Config::gradientScheme)
+    , convectionScheme(Config::convectionScheme)
+    , deferredCorrection(Config::deferredCorrection)
+    , uSolver(Config::uSolver)
+    , uPreconditioner(Config::uPreconditioner)
+    , pSolver(Config::pSolver)
+    , pPreconditioner(Config::pPreconditioner)
+{}
+
+
+void SegregatedSolver::solveMomentum(Scalar uRelax)
+{
+    if (deferredCorrection)
+    {
+        computeVelocityGradient();
+    }
+
+    m_timers["generating linear systems"].start();
+    generateMomentumSystem();
+    m_timers["generating linear systems"].stop();
+
+    if (uRelax != 1)
+    {
+        relaxSystem(m_momentumSystemMatrix, m_momentumSystemSource, m_currentVelocity, uRelax);
+    }
+
+    // Field V/A should be treated after under relaxation
+    computeVbyA();
+
+    // Solving for new velocity field
+    m_timers["solving linear systems"].start();
+    // z component is always zero in 2D, so only active components are solved
+    Index dimension = m_mesh.getDimension();
+    // Current velocity is close to the solution, especially near convergence
+    Matrix guess = velocityColumns();
+    auto sol = m_momentumSolver.solve
+    (
+        m_momentumSystemMatrix, m_momentumSystemSource.leftCols(dimension), guess, m_uSystemTolerance
+    );
+    recordLinearSolve("momentum", m_currTime, m_currIterationIdx, m_momentumSolver.getRecord());
+    for (Index cellIdx = 0; cellIdx < m_mesh.getCellAmount(); cellIdx++)
+    {
+        m_currentVelocity(cellIdx).head(dimension) = sol.row(cellIdx).transpose();
+    }
+    m_timers["solving linear systems"].stop();
+}
+
+
+Field<Scalar> SegregatedSolver::solvePressureCorrection()
+{
+    m_timers["generating linear systems"].start();
+    generatePressureCorrectionSystem();
+    m_timers["generating linear systems"].stop();
+
+    m_timers["solving linear systems"].start();
+    // Correction vanishes on convergence, so previous one is a poor guess
+    Matrix guess = Matrix::Zero(m_mesh.getCellAmount(), 1);
+    Field<Scalar> pCorrection = m_pressureSolver.solve
+    (
+        m_pressureSystemMatrix, m_pressureSystemSource, guess, m_pSystemTolerance
+    );
+    recordLinearSolve("pressure", m_currTime, m_currIterationIdx, m_pressureSolver.getRecord());
+    m_timers["solving linear systems"].stop();
+
+    return pCorrection;
+}
+
+
+void SegregatedSolver::applyPressureCorrection(Field<Scalar> const& pCorrection)
+{
+    Field<Vector> uCorrection = getVelocityCorrection(pCorrection);
+    Field<Scalar> massFluxesCorrection = getMassFluxesCorrection(pCorrection);
+
+    m_currentVelocity          += uCorrection;
+    m_currentPressure          += pCorrection;
+    m_massFluxes += massFluxesCorrection;
+}
+
+
+void SegregatedSolver::initFields()
+{
+    initFlowFields();
+
+    Index totalCells = m_mesh.getCellAmount();
+    m_momentumSystemMatrix    = SparseMatrix(totalCells, totalCells);
+    m_momentumSystemSource    = Matrix(totalCells, 3);
+    m_pressureSystemMatrix    = SparseMatrix(totalCells, totalCells);
+    m_pressureSystemSource    = Matrix(totalCells, 1);
+
+    m_momentumSolver = LinearSolver(uSolver, makeMeshPreconditioner(uPreconditioner));
+    m_pressureSolver = LinearSolver(pSolver, makeMeshPreconditioner(pPreconditioner));
+    m_momentumSolver.setRefreshThreshold(Config::preconditionerRefreshThreshold);
+    m_pressureSolver.setRefreshThreshold(Config::preconditionerRefreshThreshold);
+    m_momentumSolver.setSparseFormat(Config::sparseFormat);
+    m_pressureSolver.setSparseFormat(Config::sparseFormat);
+    m_momentumSolver.setMixedPrecision(Config::mixedPrecision);
+    m_pressureSolver.setMixedPrecision(Config::mixedPrecision);
+    m_momentumSolver.setMaxIterations(Config::maxSystemIterations);
+    m_pressureSolver.setMaxIterations(Config::maxSystemIterations);
+
+    m_uSystemTolerance = Config::uSystemTolerance;
+    m_pSystemTolerance = Config::pSystemTolerance;
+    resetLinearSolveRecords(Config::linearSolverLog);
+
+    m_pressureCorrectionBoundaries = getPressureBoundaries().homogeneous();
+
+    m_pressureGradientOperator = GradientOperator<Scalar>(m_mesh, getPressureBoundaries(), gradientScheme);
+    m_pressureCorrectionGradientOperator = GradientOperator<Scalar>(m_mesh, getPressureCorrectionBoundaries(), gradientScheme);
+
+    if (deferredCorrection)
+    {
+        // Same gradient scheme as high order convection schemes use
+        auto convectionGradientScheme = 
+        (
+            m_mesh.useNonOrthogonalCorrection
+            ? Interpolation::Schemes::Gradient::LEAST_SQAURE
+            : Interpolation::Schemes::Gradient::GREEN_GAUSE
+        );
+        m_velocityGradientOperator = GradientOperator<Vector>(m_mesh, getVelocityBoundaries(), convectionGradientScheme);
+    }
+}
+
+
+std::unique_ptr<PreconditionerBase> SegregatedSolver::makeMeshPreconditioner(LinearSolvers::Preconditioner::Type type) const
+{
+    if (type != LinearSolvers::Preconditioner::GMG)
+    {
+        return makePreconditioner(type);
+    }
+
+    // Geometric multigrid needs structured grid
+    if (auto cartesianMesh = dynamic_cast<CartesianMesh2D const*>(&m_mesh))
+    {
+        return std::make_unique<GeometricMultigridPreconditioner>
+        (
+            cartesianMesh->getXSize(), cartesianMesh->getYSize(), Config::multigridCycle
+        );
+    }
+    return makePreconditioner(LinearSolvers::Preconditioner::AMG);
+}
+
+
+void SegregatedSolver::computeVelocityGradient()
+{
+    m_timers["explicit field computation"].start();
+    m_velocityGradient = m_velocityGradientOperator.evaluate(m_currentVelocity);
+    m_timers["explicit field computation"].stop();
+}
+
+
+template<class T>
+using EqnGetter = std::function<LinearCombination<T>(Index)>;
+
+// Face fluxes are directed outwards from the owner,
+// they are computed once per face and added to both owner and neighbour equations
+template<class T, class Rhs>
+void generateSparseSystemImpl
+(
+    SparseMatrix&, 
+    Rhs&, 
+    MeshBase const& mesh, 
+    EqnGetter<T> const& faceFluxGetter, 
+    EqnGetter<T> const& cellSourceGetter
+);
+
+
+void SegregatedSolver::generateMomentumSystem()
+{
+    EqnGetter<Vector> uFaceFluxGetter = 
+    [this, &uBoundaries = getVelocityBoundaries()](Index faceIdx)
+    {
+        LinearCombination<Vector> convection = 
+        (
+            deferredCorrection
+            ? Interpolation::computeDeferredConvectionFluxOverFace
+            (
+                m_mesh, faceIdx, uBoundaries, m_massFluxes, convectionScheme, m_currentVelocity, m_velocityGradient
+            )
+            : Interpolation::computeConvectionFluxOverFace
+            (
+                m_mesh, faceIdx, uBoundaries, m_massFluxes, convectionScheme
+            )
+        );
+        
+        LinearCombination<Vector> diffusion = 
+        (
+            Config::viscosity *
+            Interpolation::computeDiffusionFluxOverFace
+            (
+                m_mesh, faceIdx, uBoundaries
+            )
+        );
+
+        LinearCombination<Vector> uFlux;
+        uFlux += convection;
+        uFlux -= diffusion;
+
+        return uFlux;
+    };
+
+    EqnGetter<Vector> uCellSourceGetter = [this](Index cellIdx)
+    {
+        Vector pressureGradient = m_pressureGradient(cellIdx) * m_mesh.getCellVolume(cellIdx);
+
+        LinearCombination<Vector> uSource;
+        uSource += pressureGradient;
+        if (isTransient())
+        {
+            uSource += transientTerm(cellIdx);
+        }
+
+        return uSource;
+    };
+
+    generateSparseSystemImpl(m_momentumSystemMatrix, m_momentumSystemSource, m_mesh, uFaceFluxGetter, uCellSourceGetter);
+}
+
+
+void SegregatedSolver::generatePressureCorrectionSystem()
+{
+    EqnGetter<Scalar> pCorrFaceFluxGetter = 
+    [this, &pCorrBoundaries = getPressureCorrectionBoundaries()](Index faceIdx)
+    {
+        Scalar VbyAf = 
+        (
+            Interpolation::valueOnFace
+            (
+                m_mesh, faceIdx, zeroGradGetter<Scalar>()
+            )
+            .evaluate(m_VbyA)
+        );
+        
+        LinearCombination<Scalar> diffusiveFlux =
+        (
+            VbyAf * Config::density * m_mesh.getFaceArea(faceIdx) *
+            Interpolation::computeFaceNormalGradient
+            (
+                m_mesh, m_mesh.getFaceOwner(faceIdx), faceIdx, pCorrBoundaries
+            )
+        );
+
+        LinearCombination<Scalar> pCorrFlux;
+        pCorrFlux -= m_massFluxes(faceIdx);
+        pCorrFlux += diffusiveFlux;
+
+        return pCorrFlux;
+    };
+
+    EqnGetter<Scalar> pCorrCellSourceGetter = [](Index)
+    {
+        return LinearCombination<Scalar>();
+    };
+    
+    generateSparseSystemImpl(m_pressureSystemMatrix, m_pressureSystemSource, m_mesh, pCorrFaceFluxGetter, pCorrCellSourceGetter);
+}
+
+
+void SegregatedSolver::computeVbyA()
+{
+    m_timers["explicit field computation"].start();
+    Index totalCells = m_mesh.getCellAmount();
+    auto diagonal = m_momentumSystemMatrix.diagonal();
+    auto const& uBoundaries = getVelocityBoundaries();
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index cellIdx = 0; cellIdx < totalCells; cellIdx++)
+    {
+        Scalar denominator = diagonal(cellIdx);
+        if (m_consistentVbyA)
+        {
+            // A - sum of A_nb is the row sum, as neighbour coefficients enter the matrix negated
+            Scalar rowSum = 0;
+            for (SparseMatrix::InnerIterator iter(m_momentumSystemMatrix, cellIdx); iter; ++iter)
+            {
+                rowSum += iter.value();
+            }
+            // Convection adds the mass imbalance of the cell to the row sum,
+            // it is far from zero on early iterations and makes the sum negative
+            for (Index faceIdx : m_mesh.getCellFaces(cellIdx))
+            {
+                // Fixed boundary velocity goes to the rhs together with its flux
+                bool fixedVelocity =
+                (
+                    m_mesh.isBoundaryFace(faceIdx)
+                    && uBoundaries(faceIdx).type == BoundaryConditionType::FIXED_VALUE
+                );
+                if (!fixedVelocity)
+                {
+                    Scalar sign = (m_mesh.getFaceOwner(faceIdx) == cellIdx ? 1 : -1);
+                    rowSum -= sign * m_massFluxes(faceIdx);
+                }
+            }
+            // Under relaxation keeps the row sum positive, high order convection may not
+            denominator = std::max(rowSum, minConsistentDiagonalFraction * denominator);
+        }
+        m_VbyA(cellIdx) = m_mesh.getCellVolume(cellIdx) / denominator;
+    }
+    m_timers["explicit field computation"].stop();
+}
+
+
+Field<Vector> SegregatedSolver::getVelocityCorrection(Field<Scalar> const& pCorrection)
+{
+    m_timers["explicit field computation"].start();
+    Index totalCells = m_mesh.getCellAmount();
+    Field<Vector> uCorrection = m_pressureCorrectionGradientOperator.evaluate(pCorrection);
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index cellIdx = 0; cellIdx < totalCells; cellIdx++)
+    {
+        uCorrection(cellIdx) *= -m_VbyA(cellIdx);
+    }
+    
+    m_timers["explicit field computation"].stop();
+    return uCorrection;
+}
+
+
+Field<Scalar> SegregatedSolver::getMassFluxesCorrection(Field<Scalar> const& pCorrection)
+{
+    m_timers["explicit field computation"].start();
+    Index totalFaces = m_mesh.getFaceAmount();
+    auto const& pCorrBoundaries = getPressureCorrectionBoundaries();
+    Field<Scalar> massFluxesCorrection(totalFaces, 1);
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index faceIdx = 0; faceIdx < totalFaces; faceIdx++)
+    {
+        Index ownerIdx = m_mesh.getFaceOwner(faceIdx);
+
+        Scalar VbyAf =
+        (
+            Interpolation::valueOnFace
+            (
+                m_mesh, faceIdx, zeroGradGetter<Scalar>()
+            )
+            .evaluate(m_VbyA)
+        );
+
+        // Same face flux as in the pressure correction equation,
+        // so corrected fluxes satisfy continuity
+        massFluxesCorrection(faceIdx) =
+        (
+            -Config::density * VbyAf * m_mesh.getFaceArea(faceIdx) *
+            Interpolation::computeFaceNormalGradient
+            (
+                m_mesh, ownerIdx, faceIdx, pCorrBoundaries
+            )
+            .evaluate(pCorrection)
+        );
+    }
+    m_timers["explicit field computation"].stop();
+    return massFluxesCorrection; 
+}
+
+
+template<class T>
+auto transpose(T vec)
+{
+    return vec.transpose();
+}
+
+template<>
+auto transpose<Scalar>(Scalar value)
+{
+    return Eigen::Matrix<Scalar, 1, 1>(value);
+}
+
+// Symbolic phase, builds sparsity pattern and fills the values
+template<class T, class Rhs>
+void assembleSparseSystemSymbolic(SparseMatrix& A, Rhs& rhs, Index size, EqnGetter<T> const& eqnGetter)
+{
+    using Triplet = Eigen::Triplet<Scalar>;
+    List<Triplet> triplets;
+
+#ifdef _OPENMP
+    List<Triplet> threadTriplets;
+    Index numThreads;
+    #pragma omp parallel
+    #pragma omp single
+    {
+        numThreads = omp_get_num_threads();
+    }
+
+    List<Index> sizes(numThreads);
+    List<Index> prefix(numThreads+1, 0);
+
+    #pragma omp parallel private(threadTriplets)
+    {
+        Index threadIdx = omp_get_thread_num();
+        Index workRangeSize  = size / numThreads + bool(threadIdx < size % numThreads);
+        Index workRangeStart = size / numThreads * threadIdx + std::min(threadIdx, size % numThreads);
+
+        for (Index eqnIdx = workRangeStart; eqnIdx < workRangeStart + workRangeSize; eqnIdx++)
+        {
+            auto eqn = eqnGetter(eqnIdx);
+
+            for (auto [coeff, varIdx] : eqn.terms)
+            {
+                threadTriplets.emplace_back(eqnIdx, varIdx, coeff);
+            }
+
+            rhs.row(eqnIdx) = -transpose(eqn.bias);
+        }
+
+        sizes[threadIdx] = threadTriplets.size();
+        #pragma omp barrier
+        
+        #pragma omp single
+        {
+            for (Index idx = 1; idx <= numThreads; idx++)
+            {
+                prefix[idx] = prefix[idx-1] + sizes[idx-1];
+            }
+            
+            triplets.resize(prefix.back());
+        }
+
+        for (Index idx = 0; idx < sizes[threadIdx]; idx++)
+        {
+            triplets[idx + prefix[threadIdx]] = threadTriplets[idx];
+        }
+    }
+#else
+    for (Index eqnIdx = 0; eqnIdx < size; eqnIdx++)
+    {
+        auto eqn = eqnGetter(eqnIdx);
+
+        for (auto [coeff, varIdx] : eqn.terms)
+        {
+            triplets.emplace_back(eqnIdx, varIdx, coeff);
+        }
+
+        rhs.row(eqnIdx) = -transpose(eqn.bias);
+    }
+#endif
+    // Keeping previous pattern, so it stops changing after a few iterations
+    // even if the stencil depends on the flow direction
+    for (Index row = 0; row < A.outerSize(); row++)
+    {
+        for (SparseMatrix::InnerIterator iter(A, row); iter; ++iter)
+        {
+            triplets.emplace_back(row, iter.col(), 0);
+        }
+    }
+
+    A = SparseMatrix(size, size);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    A.makeCompressed();
+}
+
+
+// Numeric phase, writes coefficients straight into the existing pattern
+// Returns false if some coefficient is outside of the pattern
+template<class T, class Rhs>
+bool assembleSparseSystemNumeric
+(
+    SparseMatrix& A, 
+    Rhs& rhs, 
+    MeshBase const& mesh, 
+    EqnGetter<T> const& faceFluxGetter, 
+    EqnGetter<T> const& cellSourceGetter
+)
+{
+    Index size = mesh.getCellAmount();
+    Scalar* values = A.valuePtr();
+    Index const* columns = A.innerIndexPtr();
+    Index const* rowStarts = A.outerIndexPtr();
+
+    auto addToEqn = [&](Index eqnIdx, LinearCombination<T> const& eqn, Scalar sign)
+    {
+        Index const* rowBegin = columns + rowStarts[eqnIdx];
+        Index const* rowEnd = columns + rowStarts[eqnIdx+1];
+
+        for (auto [coeff, varIdx] : eqn.terms)
+        {
+            Index const* slot = std::lower_bound(rowBegin, rowEnd, varIdx);
+            if (slot == rowEnd || *slot != varIdx)
+            {
+                return false;
+            }
+            values[slot - columns] += sign * coeff;
+        }
+
+        rhs.row(eqnIdx) -= sign * transpose(eqn.bias);
+        return true;
+    };
+
+    bool patternMatches = true;
+
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(&&:patternMatches)
+#endif
+    for (Index eqnIdx = 0; eqnIdx < size; eqnIdx++)
+    {
+        std::fill(values + rowStarts[eqnIdx], values + rowStarts[eqnIdx+1], Scalar(0));
+        rhs.row(eqnIdx).setZero();
+
+        patternMatches = addToEqn(eqnIdx, cellSourceGetter(eqnIdx), 1) && patternMatches;
+    }
+
+    // Interior faces of the same color don't share cells, so threads never write the same row
+    for (List<Index> const& faces : mesh.getFaceColors())
+    {
+        Index totalFaces = faces.size();
+
+#ifdef _OPENMP
+        #pragma omp parallel for reduction(&&:patternMatches)
+#endif
+        for (Index idx = 0; idx < totalFaces; idx++)
+        {
+            Index faceIdx = faces[idx];
+            auto [ownerIdx, neighborIdx] = mesh.getFaceNeighbors(faceIdx);
+            auto flux = faceFluxGetter(faceIdx);
+
+            patternMatches = addToEqn(ownerIdx, flux, 1) && patternMatches;
+            patternMatches = addToEqn(neighborIdx, flux, -1) && patternMatches;
+        }
+    }
+
+    // Boundary faces have only the owner, a cell may own several faces of one patch
+    for (auto [patchBegin, patchEnd] : mesh.getBoundaryPatches())
+    {
+        for (Index faceIdx = patchBegin; faceIdx < patchEnd; faceIdx++)
+        {
+            patternMatches = addToEqn(mesh.getFaceOwner(faceIdx), faceFluxGetter(faceIdx), 1) && patternMatches;
+        }
+    }
+
+    return patternMatches;
+}
+
+
+template<class T, class Rhs>
+void generateSparseSystemImpl
+(
+    SparseMatrix& A, 
+    Rhs& rhs, 
+    MeshBase const& mesh, 
+    EqnGetter<T> const& faceFluxGetter, 
+    EqnGetter<T> const& cellSourceGetter
+)
+{
+    bool hasPattern = A.nonZeros() > 0 && A.isCompressed();
+
+    if (hasPattern && assembleSparseSystemNumeric(A, rhs, mesh, faceFluxGetter, cellSourceGetter))
+    {
+        return;
+    }
+
+    EqnGetter<T> eqnGetter = [&](Index cellIdx)
+    {
+        LinearCombination<T> eqn = cellSourceGetter(cellIdx);
+        eqn += Interpolation::sumFluxesOverCell<T>(mesh, cellIdx, faceFluxGetter);
+        return eqn;
+    };
+
+    assembleSparseSystemSymbolic(A, rhs, mesh.getCellAmount(), eqnGetter);
+}
+
+
+Matrix SegregatedSolver::velocityColumns() const
+{
+    // z component is always zero in 2D
+    Index dimension = m_mesh.getDimension();
+    Matrix velocity(m_mesh.getCellAmount(), dimension);
+    for (Index cellIdx = 0; cellIdx < m_mesh.getCellAmount(); cellIdx++)
+    {
+        velocity.row(cellIdx) = m_currentVelocity(cellIdx).head(dimension).transpose();
+    }
+    return velocity;
+}
+
+
+Scalar SegregatedSolver::maxCourantNumber() const
+{
+    Index totalCells = m_mesh.getCellAmount();
+    Scalar maxCourant = 0;
+
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(max:maxCourant)
+#endif
+    for (Index cellIdx = 0; cellIdx < totalCells; cellIdx++)
+    {
+        // Half of the total flux over the faces is the flux through the cell
+        Scalar totalFlux = 0;
+        for (Index faceIdx : m_mesh.getCellFaces(cellIdx))
+        {
+            totalFlux += std::abs(m_massFluxes(faceIdx));
+        }
+        Scalar courant = m_timeStep * totalFlux / (2 * Config::density * m_mesh.getCellVolume(cellIdx));
+        maxCourant = std::max(maxCourant, courant);
+    }
+
+    return maxCourant;
+}
+
+
+Scalar SegregatedSolver::relativeResidual(Matrix const& field, Matrix const& correction)
+{
+    m_timers["computing residuals"].start();
+    Scalar fieldMax = std::max(field.maxCoeff(), -field.minCoeff());
+    Scalar corrMax  = std::max(correction.maxCoeff(), -correction.minCoeff());
+    m_timers["computing residuals"].stop();
+    
+    return corrMax / fieldMax;
+}
+
+
+BoundaryTable<Vector> const& SegregatedSolver::getVelocityBoundaries() const
+{
+    return m_mesh.getVelocityBoundaries();
+}
+
+
+BoundaryTable<Scalar> const& SegregatedSolver::getPressureBoundaries() const
+{
+    return m_mesh.getPressureBoundaries();
+}
+
+
+BoundaryTable<Scalar> const& SegregatedSolver::getPressureCorrectionBoundaries() const
+{
+    return m_pressureCorrectionBoundaries;
+}
\ No newline at end of file
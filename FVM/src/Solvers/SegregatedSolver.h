@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Utils/Types.h"
+#include "Mesh/MeshBase.h"
+#include "Solvers/SolverBase.h"
+#include "Discretization/GradientOperator.h"
+#include "Discretization/Schemes/InterpolationSchemes.h"
+#include "Utils/LinearSolvers/LinearSolverTypes.h"
+#include "Utils/LinearSolvers/Preconditioners.h"
+#include "Utils/LinearSolvers/LinearSolver.h"
+
+
+// Momentum predictor, Rhie-Chow mass fluxes and pressure correction
+// shared by the segregated pressure-velocity coupling algorithms
+class SegregatedSolver : public SolverBase
+{
+public:
+
+    SegregatedSolver(MeshBase const& mesh);
+
+    // Schemes
+    Interpolation::Schemes::Gradient::Type gradientScheme;
+    Interpolation::Schemes::Convection::Type convectionScheme;
+    bool deferredCorrection;
+
+    // Linear solvers for momentum and pressure correction systems
+    LinearSolvers::Solver::Type uSolver;
+    LinearSolvers::Preconditioner::Type uPreconditioner;
+    LinearSolvers::Solver::Type pSolver;
+    LinearSolvers::Preconditioner::Type pPreconditioner;
+
+protected:
+
+    // Only for deferred correction
+    Field<Tensor> m_velocityGradient;
+
+    // Same as pressure boundaries but with zero values
+    BoundaryTable<Scalar> m_pressureCorrectionBoundaries;
+
+    // Gradient operators, built once per solve
+    GradientOperator<Scalar> m_pressureCorrectionGradientOperator;
+    GradientOperator<Vector> m_velocityGradientOperator;
+
+    // Momentum matrix and rhs
+    SparseMatrix m_momentumSystemMatrix;
+    Matrix m_momentumSystemSource;
+
+    // Pressure correction matrix and rhs
+    SparseMatrix m_pressureSystemMatrix;
+    Matrix m_pressureSystemSource;
+
+    // Kept between iterations and time steps, preconditioners are rebuilt
+    // only when matrix diagonal drifts
+    LinearSolver m_momentumSolver;
+    LinearSolver m_pressureSolver;
+
+    Scalar m_uSystemTolerance;
+    Scalar m_pSystemTolerance;
+
+    // SIMPLEC, V/A is replaced by V/(A - sum of A_nb) consistent with dropped neighbour corrections
+    bool m_consistentVbyA = false;
+    static constexpr Scalar minConsistentDiagonalFraction = 0.05;
+
+
+    virtual void initFields();
+    std::unique_ptr<PreconditionerBase> makeMeshPreconditioner(LinearSolvers::Preconditioner::Type type) const;
+    void computeVelocityGradient();
+    // Relaxation factor 1 keeps the system as is
+    void solveMomentum(Scalar uRelax);
+    Field<Scalar> solvePressureCorrection();
+    // Corrects velocity, pressure and mass fluxes with already relaxed pressure correction
+    void applyPressureCorrection(Field<Scalar> const& pCorrection);
+
+    void generateMomentumSystem();
+    void generatePressureCorrectionSystem();
+    void computeVbyA();
+    Field<Vector> getVelocityCorrection(Field<Scalar> const& pCorrection);
+    Field<Scalar> getMassFluxesCorrection(Field<Scalar> const& pCorrection);
+
+    // Active velocity components as columns
+    Matrix velocityColumns() const;
+
+    Scalar relativeResidual(Matrix const& field, Matrix const& correction);
+    // Maximum over cells of the time step times volume flux through the cell over its volume
+    Scalar maxCourantNumber() const;
+
+    BoundaryTable<Vector> const& getVelocityBoundaries() const;
+    BoundaryTable<Scalar> const& getPressureBoundaries() const;
+    BoundaryTable<Scalar> const& getPressureCorrectionBoundaries() const;
+};
@@ -0,0 +1,89 @@
+#include "SnapshotSinks.h"
+
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+
+
+MemorySnapshotSink::MemorySnapshotSink(Index keepEvery) : m_keepEvery(keepEvery) {}
+
+
+void MemorySnapshotSink::write(Index timePointIdx, Scalar time, Field<Vector> const& velocity, Field<Scalar> const& pressure)
+{
+    if (m_latestIsExtra)
+    {
+        // Buffers of the replaced snapshot are reused
+        m_times.back() = time;
+        m_velocity.back() = velocity;
+        m_pressure.back() = pressure;
+    }
+    else
+    {
+        m_times.push_back(time);
+        m_velocity.push_back(velocity);
+        m_pressure.push_back(pressure);
+    }
+
+    m_latestIsExtra = (m_keepEvery <= 0 || timePointIdx % m_keepEvery != 0);
+}
+
+
+Index MemorySnapshotSink::getSnapshotAmount() const
+{
+    assert(m_velocity.size() == m_pressure.size());
+    return m_velocity.size();
+}
+
+
+Scalar MemorySnapshotSink::getTime(Index snapshotIdx) const
+{
+    return m_times[snapshotIdx];
+}
+
+
+Field<Vector> const& MemorySnapshotSink::getVelocity(Index snapshotIdx) const
+{
+    return m_velocity[snapshotIdx];
+}
+
+
+Field<Scalar> const& MemorySnapshotSink::getPressure(Index snapshotIdx) const
+{
+    return m_pressure[snapshotIdx];
+}
+
+
+CsvSnapshotSink::CsvSnapshotSink(std::string const& path) : m_file(path)
+{
+    if (!m_file)
+    {
+        throw std::runtime_error("Can't open snapshot file " + path + "\n");
+    }
+
+    m_file.precision(std::numeric_limits<Scalar>::max_digits10);
+    m_file << "time_point,time,cell,ux,uy,uz,p\n";
+}
+
+
+void CsvSnapshotSink::write(Index timePointIdx, Scalar time, Field<Vector> const& velocity, Field<Scalar> const& pressure)
+{
+    assert(velocity.size() == pressure.size());
+
+    for (Index cellIdx = 0; cellIdx < pressure.size(); cellIdx++)
+    {
+        Vector const& u = velocity(cellIdx);
+        m_file << timePointIdx << ',' << time << ',' << cellIdx << ','
+            << u.x() << ',' << u.y() << ',' << u.z() << ',' << pressure(cellIdx) << '\n';
+    }
+    // Whole time point is on disk if the run is interrupted
+    m_file.flush();
+}
+
+
+CallbackSnapshotSink::CallbackSnapshotSink(Callback callback) : m_callback(std::move(callback)) {}
+
+
+void CallbackSnapshotSink::write(Index timePointIdx, Scalar time, Field<Vector> const& velocity, Field<Scalar> const& pressure)
+{
+    m_callback(timePointIdx, time, velocity, pressure);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Utils/Types.h"
+
+#include <fstream>
+#include <functional>
+#include <string>
+
+
+// Receives fields of every time point the solver produces.
+// Fields are not referenced after the call
+class SnapshotSink
+{
+public:
+
+    virtual ~SnapshotSink() = default;
+
+    virtual void write(Index timePointIdx, Scalar time, Field<Vector> const& velocity, Field<Scalar> const& pressure) = 0;
+};
+
+
+// Keeps every N-th time point in memory. The latest one is kept as well,
+// until the next time point replaces it, so the history always ends with it
+class MemorySnapshotSink : public SnapshotSink
+{
+public:
+
+    // Non positive value keeps only the latest time point
+    explicit MemorySnapshotSink(Index keepEvery = 1);
+
+    void write(Index timePointIdx, Scalar time, Field<Vector> const& velocity, Field<Scalar> const& pressure) override;
+
+    Index getSnapshotAmount() const;
+    Scalar getTime(Index snapshotIdx) const;
+    Field<Vector> const& getVelocity(Index snapshotIdx) const;
+    Field<Scalar> const& getPressure(Index snapshotIdx) const;
+
+private:
+
+    Index m_keepEvery;
+    // Latest snapshot is not the N-th one and is replaced by the next
+    bool m_latestIsExtra = false;
+
+    List<Scalar> m_times;
+    List<Field<Vector>> m_velocity;
+    List<Field<Scalar>> m_pressure;
+};
+
+
+// Appends cell values of every time point to CSV file
+class CsvSnapshotSink : public SnapshotSink
+{
+public:
+
+    explicit CsvSnapshotSink(std::string const& path);
+
+    void write(Index timePointIdx, Scalar time, Field<Vector> const& velocity, Field<Scalar> const& pressure) override;
+
+private:
+
+    std::ofstream m_file;
+};
+
+
+class CallbackSnapshotSink : public SnapshotSink
+{
+public:
+
+    using Callback = std::function<void(Index, Scalar, Field<Vector> const&, Field<Scalar> const&)>;
+
+    explicit CallbackSnapshotSink(Callback callback);
+
+    void write(Index timePointIdx, Scalar time, Field<Vector> const& velocity, Field<Scalar> const& pressure) override;
+
+private:
+
+    Callback m_callback;
+};
@@ -1,9 +1,22 @@
 #include "SolverBase.h"
+#include "Config/Config.h"
+#include "Discretization/Interpolation.h"
 
 #include <cassert>
+#include <iostream>
+#include <stdexcept>
 
 
-SolverBase::SolverBase(MeshBase const& mesh) : m_mesh(mesh) {}
+SolverBase::SolverBase(MeshBase const& mesh)
+    : m_mesh(mesh)
+    , m_history(Config::snapshotInterval)
+{
+    // Face kernels loop over the interior range and the boundary patches
+    if (!m_mesh.isRenumbered())
+    {
+        throw std::invalid_argument("Mesh should be built with boundary faces last\n");
+    }
+}
 
 bool SolverBase::isTransient() const
 {
@@ -17,8 +30,12 @@ void SolverBase::setTransient(bool state)
 
 Index SolverBase::getTimePointAmount() const
 {
-    assert(m_velocity.size() == m_pressure.size());
-    return m_velocity.size();
+    return m_history.getSnapshotAmount();
+}
+
+Scalar SolverBase::getTime(Index timePointIdx) const
+{
+    return m_history.getTime(timePointIdx);
 }
 
 MeshBase const& SolverBase::getMesh() const
@@ -28,15 +45,154 @@ MeshBase const& SolverBase::getMesh() const
 
 Field<Vector> const& SolverBase::getVelocity(Index timePointIdx) const
 {
-    return m_velocity[timePointIdx];
+    return m_history.getVelocity(timePointIdx);
 }
 
 Field<Scalar> const& SolverBase::getPressure(Index timePointIdx) const
 {
-    return m_pressure[timePointIdx];
+    return m_history.getPressure(timePointIdx);
+}
+
+void SolverBase::addSnapshotSink(std::unique_ptr<SnapshotSink> sink)
+{
+    assert(sink);
+    m_snapshotSinks.push_back(std::move(sink));
 }
 
 bool SolverBase::isConverged() const
 {
     return m_converged;
 }
+
+LinearSolveSummary const& SolverBase::getLinearSolveSummary(std::string const& equation) const
+{
+    static LinearSolveSummary const noSolves;
+
+    auto iter = m_linearSolveSummaries.find(equation);
+    return iter != m_linearSolveSummaries.end() ? iter->second : noSolves;
+}
+
+void SolverBase::resetLinearSolveRecords(std::string const& logPath)
+{
+    m_linearSolveSummaries.clear();
+    m_linearSolveLog = LinearSolveLog(logPath);
+}
+
+void SolverBase::recordLinearSolve(std::string const& equation, Scalar time, Index outerIteration, LinearSolveRecord const& record)
+{
+    m_linearSolveSummaries[equation].add(record);
+    m_linearSolveLog.write(equation, time, outerIteration, record);
+}
+
+void SolverBase::storeTimePoint(Scalar time, Field<Vector> const& velocity, Field<Scalar> const& pressure)
+{
+    m_history.write(m_storedTimePointAmount, time, velocity, pressure);
+    for (auto const& sink : m_snapshotSinks)
+    {
+        sink->write(m_storedTimePointAmount, time, velocity, pressure);
+    }
+    m_storedTimePointAmount++;
+}
+
+Field<Vector> const& SolverBase::getLatestVelocity() const
+{
+    return m_history.getVelocity(m_history.getSnapshotAmount() - 1);
+}
+
+void SolverBase::initFlowFields()
+{
+    Index totalCells = m_mesh.getCellAmount();
+    Index totalFaces = m_mesh.getFaceAmount();
+
+    // Initial guesses
+    m_currentPressure = Field<Scalar>::Constant(totalCells, 0);
+    m_currentVelocity = Field<Vector>::Constant(totalCells, {0,0,0});
+    m_pressureGradient = Field<Vector>::Constant(totalCells, {0,0,0});
+    m_VbyA = Field<Scalar>(totalCells);
+    m_timeStep = Config::timeStep;
+    m_timers.clear();
+
+    // Init mass fluxes
+    // Can't be just zero because of boundary values
+    auto const& uBoundaries = m_mesh.getVelocityBoundaries();
+    m_massFluxes = Field<Scalar>(totalFaces);
+    for (Index faceIdx = 0; faceIdx < totalFaces; faceIdx++)
+    {
+        if
+        (
+            m_mesh.isBoundaryFace(faceIdx)
+            && uBoundaries(faceIdx).type == BoundaryConditionType::FIXED_VALUE
+        )
+        {
+            m_massFluxes(faceIdx) =
+            (
+                Config::density *
+                uBoundaries(faceIdx).value.dot(m_mesh.getFaceVector(faceIdx))
+            );
+        }
+        else
+        {
+            m_massFluxes(faceIdx) = 0;
+        }
+    }
+}
+
+void SolverBase::computePressureGradient()
+{
+    m_timers["explicit field computation"].start();
+    m_pressureGradient = m_pressureGradientOperator.evaluate(m_currentPressure);
+    m_timers["explicit field computation"].stop();
+}
+
+void SolverBase::computeMassFluxes()
+{
+    m_timers["explicit field computation"].start();
+    Index interiorFaces = m_mesh.getInteriorFaceAmount();
+    auto const& pBoundaries = m_mesh.getPressureBoundaries();
+    auto const& uBoundaries = m_mesh.getVelocityBoundaries();
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index faceIdx = 0; faceIdx < interiorFaces; faceIdx++)
+    {
+        Vector faceVelocity =
+        (
+            Interpolation::computeRhieChowVelocityOnInteriorFace
+            (
+                m_mesh, faceIdx, m_currentVelocity, m_currentPressure, m_pressureGradient, m_VbyA, uBoundaries, pBoundaries
+            )
+        );
+
+        m_massFluxes(faceIdx) = faceVelocity.dot(m_mesh.getFaceVector(faceIdx)) * Config::density;
+    }
+
+    // Boundary velocity is taken as is, without the pressure correction
+    for (auto [patchBegin, patchEnd] : m_mesh.getBoundaryPatches())
+    {
+        for (Index faceIdx = patchBegin; faceIdx < patchEnd; faceIdx++)
+        {
+            Vector faceVelocity = Interpolation::valueOnFace(m_mesh, faceIdx, uBoundaries).evaluate(m_currentVelocity);
+            m_massFluxes(faceIdx) = faceVelocity.dot(m_mesh.getFaceVector(faceIdx)) * Config::density;
+        }
+    }
+
+    m_timers["explicit field computation"].stop();
+}
+
+LinearCombination<Vector> SolverBase::transientTerm(Index cellIdx) const
+{
+    LinearCombination<Vector> term = {{1, cellIdx}};
+    term -= getLatestVelocity()(cellIdx);
+    term *= m_mesh.getCellVolume(cellIdx) * Config::density / m_timeStep;
+    return term;
+}
+
+void SolverBase::printTimers() const
+{
+    // How much time elapsed
+    for (auto&& [eventName, eventTimer] : m_timers)
+    {
+        std::cout << eventTimer.getElapsedTime() << " seconds for " << eventName << "\n\n";
+    }
+}
@@ -1,7 +1,15 @@
 #pragma once
 
 #include "Utils/Types.h"
+#include "Utils/Timer.h"
 #include "Mesh/MeshBase.h"
+#include "Discretization/GradientOperator.h"
+#include "Discretization/LinearCombination.h"
+#include "Utils/LinearSolvers/LinearSolveRecord.h"
+#include "SnapshotSinks.h"
+
+#include <memory>
+#include <string>
 
 
 class SolverBase
@@ -15,18 +23,69 @@ public:
 
     bool isTransient() const;
     void setTransient(bool state = true);
+
+    // Time points kept in memory, every Config::snapshotInterval-th and the latest one
     Index getTimePointAmount() const;
+    Scalar getTime(Index timePointIdx) const;
 
     MeshBase const& getMesh() const;
     Field<Vector> const& getVelocity(Index timePointIdx) const;
     Field<Scalar> const& getPressure(Index timePointIdx) const;
 
+    // Every time point is passed to the sink as well, e.g. to write it to disk
+    void addSnapshotSink(std::unique_ptr<SnapshotSink> sink);
+
+    // Totals and the last solve of the equation, empty for unknown equation.
+    // Memory doesn't grow with the run, every solve is in Config::linearSolverLog
+    LinearSolveSummary const& getLinearSolveSummary(std::string const& equation) const;
+
 protected:
 
     MeshBase const& m_mesh;
-    List<Field<Vector>> m_velocity;
-    List<Field<Scalar>> m_pressure;
 
     bool m_converged;
     bool m_isTransient = false;
+
+    // Fields in the current iteration
+    Field<Vector> m_currentVelocity;
+    Field<Scalar> m_currentPressure;
+    Field<Vector> m_pressureGradient;
+    Field<Scalar> m_VbyA;
+    Field<Scalar> m_massFluxes;
+
+    // Built by the derived solver with its gradient scheme
+    GradientOperator<Scalar> m_pressureGradientOperator;
+
+    HashMap<std::string, Timer> m_timers;
+
+    Index m_currIterationIdx;
+    Scalar m_currTime;
+    // Transient term uses it instead of Config::timeStep, so the step may change during the run
+    Scalar m_timeStep;
+
+    // Zero fields, mass fluxes of fixed boundary velocities and Config::timeStep
+    void initFlowFields();
+    void computePressureGradient();
+    // Rhie-Chow interpolation with the current V/A
+    void computeMassFluxes();
+    // Implicit Euler term of the cell momentum equation
+    LinearCombination<Vector> transientTerm(Index cellIdx) const;
+    void printTimers() const;
+
+    // Clears records and starts CSV log at logPath, empty path disables the log
+    void resetLinearSolveRecords(std::string const& logPath = "");
+    void recordLinearSolve(std::string const& equation, Scalar time, Index outerIteration, LinearSolveRecord const& record);
+
+    void storeTimePoint(Scalar time, Field<Vector> const& velocity, Field<Scalar> const& pressure);
+    // Fields of the latest stored time point, the only ones implicit Euler needs
+    Field<Vector> const& getLatestVelocity() const;
+
+private:
+
+    MemorySnapshotSink m_history;
+    List<std::unique_ptr<SnapshotSink>> m_snapshotSinks;
+    Index m_storedTimePointAmount = 0;
+
+    HashMap<std::string, LinearSolveSummary> m_linearSolveSummaries;
+    LinearSolveLog m_linearSolveLog;
 };
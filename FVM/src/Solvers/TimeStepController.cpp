@@ -0,0 +1,24 @@
+#include "TimeStepController.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+TimeStepController::TimeStepController(Scalar targetCourant, Scalar minTimeStep, Scalar maxTimeStep, Scalar maxGrowth)
+    : m_targetCourant(targetCourant)
+    , m_minTimeStep(minTimeStep)
+    , m_maxTimeStep(maxTimeStep)
+    , m_maxGrowth(maxGrowth)
+{
+    assert(targetCourant > 0 && minTimeStep <= maxTimeStep && maxGrowth >= 1);
+}
+
+
+Scalar TimeStepController::next(Scalar timeStep, Scalar courant) const
+{
+    // Courant number is proportional to the time step for the same flow
+    Scalar factor = (courant > 0 ? m_targetCourant / courant : m_maxGrowth);
+    factor = std::min(factor, m_maxGrowth);
+
+    return std::clamp(factor * timeStep, m_minTimeStep, m_maxTimeStep);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Utils/Types.h"
+
+
+// Time step of one finished step and its maximum Courant number
+struct TimeStepRecord
+{
+    Scalar time;
+    Scalar timeStep;
+    Scalar courant;
+};
+
+
+// Scales time step toward the target Courant number within bounds.
+// Growth per step is limited, as the Courant number of quiescent phases
+// says little about the next ones, shrinking is not limited
+class TimeStepController
+{
+public:
+
+    TimeStepController(Scalar targetCourant, Scalar minTimeStep, Scalar maxTimeStep, Scalar maxGrowth = 1.2);
+
+    // Next time step given the last one and the Courant number it gave
+    Scalar next(Scalar timeStep, Scalar courant) const;
+
+private:
+
+    Scalar m_targetCourant;
+    Scalar m_minTimeStep;
+    Scalar m_maxTimeStep;
+    Scalar m_maxGrowth;
+};
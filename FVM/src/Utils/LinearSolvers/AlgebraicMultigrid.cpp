@@ -0,0 +1,292 @@
+#include "AlgebraicMultigrid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+// Greedy aggregation by strong connections,
+// returns amount of aggregates
+static Index aggregate(SparseMatrix const& A, Scalar threshold, List<Index>& aggregates)
+{
+    Index size = A.rows();
+    Field<Scalar> diagonal = A.diagonal().cwiseAbs();
+
+    auto forStrongNeighbors = [&](Index row, auto&& func)
+    {
+        for (SparseMatrix::InnerIterator iter(A, row); iter; ++iter)
+        {
+            Index col = iter.col();
+            if (col != row && std::abs(iter.value()) >= threshold * std::sqrt(diagonal(row) * diagonal(col)))
+            {
+                func(col, std::abs(iter.value()));
+            }
+        }
+    };
+
+    aggregates.assign(size, -1);
+    Index count = 0;
+
+    // Roots whose strong neighbors are all free
+    for (Index row = 0; row < size; row++)
+    {
+        if (aggregates[row] != -1)
+        {
+            continue;
+        }
+
+        bool hasNeighbors = false;
+        bool neighborsFree = true;
+        forStrongNeighbors(row, [&](Index col, Scalar)
+        {
+            hasNeighbors = true;
+            neighborsFree = neighborsFree && aggregates[col] == -1;
+        });
+
+        if (hasNeighbors && neighborsFree)
+        {
+            aggregates[row] = count;
+            forStrongNeighbors(row, [&](Index col, Scalar)
+            {
+                aggregates[col] = count;
+            });
+            count++;
+        }
+    }
+
+    // Joining the most strongly connected aggregate from the first pass
+    List<Index> rootAggregates = aggregates;
+    for (Index row = 0; row < size; row++)
+    {
+        if (aggregates[row] != -1)
+        {
+            continue;
+        }
+
+        Scalar strongest = 0;
+        forStrongNeighbors(row, [&](Index col, Scalar value)
+        {
+            if (rootAggregates[col] != -1 && value > strongest)
+            {
+                strongest = value;
+                aggregates[row] = rootAggregates[col];
+            }
+        });
+    }
+
+    // Leftovers form aggregates with their free neighbors
+    for (Index row = 0; row < size; row++)
+    {
+        if (aggregates[row] != -1)
+        {
+            continue;
+        }
+
+        aggregates[row] = count;
+        forStrongNeighbors(row, [&](Index col, Scalar)
+        {
+            if (aggregates[col] == -1)
+            {
+                aggregates[col] = count;
+            }
+        });
+        count++;
+    }
+
+    return count;
+}
+
+
+// P = (I - omega D^-1 A) P_tent, where P_tent is piecewise constant over aggregates
+static SparseMatrix smoothedProlongation
+(
+    SparseMatrix const& A,
+    Field<Scalar> const& inverseDiagonal,
+    List<Index> const& aggregates,
+    Index coarseSize
+)
+{
+    Index size = A.rows();
+
+    // Spectral radius of D^-1 A bounded by Gershgorin circles
+    Scalar spectralRadius = 0;
+    for (Index row = 0; row < size; row++)
+    {
+        Scalar rowSum = 0;
+        for (SparseMatrix::InnerIterator iter(A, row); iter; ++iter)
+        {
+            rowSum += std::abs(iter.value());
+        }
+        spectralRadius = std::max(spectralRadius, rowSum * std::abs(inverseDiagonal(row)));
+    }
+    Scalar omega = 4.0 / 3.0 / spectralRadius;
+
+    List<Eigen::Triplet<Scalar>> triplets;
+    triplets.reserve(A.nonZeros() + size);
+    for (Index row = 0; row < size; row++)
+    {
+        triplets.emplace_back(row, aggregates[row], 1);
+        for (SparseMatrix::InnerIterator iter(A, row); iter; ++iter)
+        {
+            triplets.emplace_back(row, aggregates[iter.col()], -omega * inverseDiagonal(row) * iter.value());
+        }
+    }
+
+    SparseMatrix P(size, coarseSize);
+    P.setFromTriplets(triplets.begin(), triplets.end());
+    return P;
+}
+
+
+template<class T>
+static void gaussSeidel
+(
+    Eigen::SparseMatrix<T, Eigen::RowMajor> const& A,
+    Field<T> const& inverseDiagonal,
+    Field<T> const& b,
+    Field<T>& x,
+    bool forward
+)
+{
+    Index size = A.rows();
+    for (Index step = 0; step < size; step++)
+    {
+        Index row = forward ? step : size - 1 - step;
+
+        T residual = b(row);
+        for (typename Eigen::SparseMatrix<T, Eigen::RowMajor>::InnerIterator iter(A, row); iter; ++iter)
+        {
+            residual -= iter.value() * x(iter.col());
+        }
+        x(row) += residual * inverseDiagonal(row);
+    }
+}
+
+
+void AMGPreconditioner::compute(SparseMatrix const& A)
+{
+    assert(A.rows() == A.cols());
+
+    bool reuseAggregates = samePattern(A);
+    if (!reuseAggregates)
+    {
+        m_levels.clear();
+        m_rowStarts.assign(A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1);
+        m_columns.assign(A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros());
+    }
+
+    SparseMatrix current = A;
+    current.makeCompressed();
+
+    for (Index levelIdx = 0; ; levelIdx++)
+    {
+        if (reuseAggregates && levelIdx == Index(m_levels.size()))
+        {
+            break;
+        }
+
+        if (!reuseAggregates)
+        {
+            if (current.rows() <= coarsestSize || levelIdx + 1 >= maxLevels)
+            {
+                break;
+            }
+
+            List<Index> aggregates;
+            Index coarseSize = aggregate(current, strengthThreshold, aggregates);
+
+            // Coarsening stalled
+            if (10 * coarseSize > 9 * current.rows())
+            {
+                break;
+            }
+
+            m_levels.emplace_back();
+            m_levels.back().aggregates = std::move(aggregates);
+            m_levels.back().coarseSize = coarseSize;
+        }
+
+        Level& level = m_levels[levelIdx];
+        MultigridOperators<Scalar>& operators = level.operators;
+        operators.A = std::move(current);
+        level.computeInverseDiagonal();
+        operators.P = smoothedProlongation(operators.A, operators.inverseDiagonal, level.aggregates, level.coarseSize);
+        operators.R = operators.P.transpose();
+
+        // Galerkin coarse operator
+        SparseMatrix AP = operators.A * operators.P;
+        current = operators.R * AP;
+        current.makeCompressed();
+
+        if (m_singlePrecision)
+        {
+            level.computeSingleOperators();
+        }
+    }
+
+    m_coarsestSolver.compute(current);
+}
+
+
+void AMGPreconditioner::apply(Field<Scalar> const& r, Field<Scalar>& z) const
+{
+    cycle(0, r, z);
+}
+
+
+void AMGPreconditioner::applySingle(Field<float> const& r, Field<float>& z) const
+{
+    cycle(0, r, z);
+}
+
+
+Index AMGPreconditioner::getLevelAmount() const
+{
+    return m_levels.size() + 1;
+}
+
+
+bool AMGPreconditioner::samePattern(SparseMatrix const& A) const
+{
+    if (m_levels.empty() || !A.isCompressed() || Index(m_rowStarts.size()) != A.outerSize() + 1)
+    {
+        return false;
+    }
+
+    return
+    (
+        std::equal(m_rowStarts.begin(), m_rowStarts.end(), A.outerIndexPtr())
+        && Index(m_columns.size()) == A.nonZeros()
+        && std::equal(m_columns.begin(), m_columns.end(), A.innerIndexPtr())
+    );
+}
+
+
+template<class T>
+void AMGPreconditioner::cycle(Index levelIdx, Field<T> const& b, Field<T>& x) const
+{
+    if (levelIdx == Index(m_levels.size()))
+    {
+        m_coarsestSolver.solve(b, x);
+        return;
+    }
+
+    auto const& [A, inverseDiagonal, P, R] = m_levels[levelIdx].operatorsOf<T>();
+
+    // Forward sweeps before and backward after keep the cycle symmetric for CG
+    x.setZero(b.rows());
+    for (Index step = 0; step < smoothingSteps; step++)
+    {
+        gaussSeidel(A, inverseDiagonal, b, x, true);
+    }
+
+    Field<T> coarseB = R * (b - A * x);
+    Field<T> coarseX;
+    cycle(levelIdx + 1, coarseB, coarseX);
+    x += P * coarseX;
+
+    for (Index step = 0; step < smoothingSteps; step++)
+    {
+        gaussSeidel(A, inverseDiagonal, b, x, false);
+    }
+}
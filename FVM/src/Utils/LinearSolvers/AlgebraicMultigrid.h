@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Utils/Types.h"
+#include "Preconditioners.h"
+#include "MultigridLevel.h"
+
+
+// Smoothed aggregation AMG, apply performs one symmetric V-cycle.
+// Aggregates depend only on the matrix pattern and are reused
+// while it stays the same, then only the Galerkin products are recomputed
+class AMGPreconditioner : public PreconditionerBase
+{
+public:
+
+    void compute(SparseMatrix const& A) override;
+    void apply(Field<Scalar> const& r, Field<Scalar>& z) const override;
+    void applySingle(Field<float> const& r, Field<float>& z) const override;
+
+    Index getLevelAmount() const;
+
+private:
+
+    // Systems not larger than this are solved directly
+    static constexpr Index coarsestSize = 64;
+    static constexpr Index maxLevels = 20;
+    // Connection is strong if |a_ij| >= theta * sqrt(|a_ii * a_jj|)
+    static constexpr Scalar strengthThreshold = 0.08;
+    static constexpr Index smoothingSteps = 1;
+
+    // Prolongation of the level is smoothed
+    struct Level : MultigridLevel
+    {
+        // Aggregate of each node, defines tentative prolongation
+        List<Index> aggregates;
+        Index coarseSize;
+    };
+
+    List<Level> m_levels;
+    MultigridCoarsestSolver m_coarsestSolver;
+
+    // Pattern of the finest matrix the aggregates were built for
+    List<Index> m_rowStarts;
+    List<Index> m_columns;
+
+    bool samePattern(SparseMatrix const& A) const;
+    void buildAggregates(SparseMatrix const& A);
+    void computeLevels(SparseMatrix const& A);
+
+    template<class T>
+    void cycle(Index levelIdx, Field<T> const& b, Field<T>& x) const;
+};
@@ -0,0 +1,64 @@
+#include "DirectSolvers.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+template<class Decomposition>
+void DirectPreconditioner<Decomposition>::compute(SparseMatrix const& A)
+{
+    SparseMatrix compressed = A;
+    compressed.makeCompressed();
+
+    // Decompositions work with column major matrices
+    Eigen::SparseMatrix<Scalar> matrix = compressed;
+
+    if (!samePattern(compressed))
+    {
+        m_decomposition.analyzePattern(matrix);
+        m_rowStarts.assign(compressed.outerIndexPtr(), compressed.outerIndexPtr() + compressed.outerSize() + 1);
+        m_columns.assign(compressed.innerIndexPtr(), compressed.innerIndexPtr() + compressed.nonZeros());
+        m_analysisAmount++;
+    }
+
+    m_decomposition.factorize(matrix);
+    if (m_decomposition.info() != Eigen::Success)
+    {
+        throw std::runtime_error("Sparse factorization failed\n");
+    }
+}
+
+
+template<class Decomposition>
+void DirectPreconditioner<Decomposition>::apply(Field<Scalar> const& r, Field<Scalar>& z) const
+{
+    z = m_decomposition.solve(r);
+}
+
+
+template<class Decomposition>
+Index DirectPreconditioner<Decomposition>::getAnalysisAmount() const
+{
+    return m_analysisAmount;
+}
+
+
+template<class Decomposition>
+bool DirectPreconditioner<Decomposition>::samePattern(SparseMatrix const& A) const
+{
+    if (Index(m_rowStarts.size()) != A.outerSize() + 1)
+    {
+        return false;
+    }
+
+    return
+    (
+        std::equal(m_rowStarts.begin(), m_rowStarts.end(), A.outerIndexPtr())
+        && Index(m_columns.size()) == A.nonZeros()
+        && std::equal(m_columns.begin(), m_columns.end(), A.innerIndexPtr())
+    );
+}
+
+
+template class DirectPreconditioner<Eigen::SimplicialLDLT<Eigen::SparseMatrix<Scalar>>>;
+template class DirectPreconditioner<Eigen::SparseLU<Eigen::SparseMatrix<Scalar>, Eigen::COLAMDOrdering<Index>>>;
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Utils/Types.h"
+#include "Preconditioners.h"
+
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseLU>
+
+
+// Sparse direct factorization used as exact preconditioner,
+// with Richardson solver it is a direct solve followed by a residual check.
+// Symbolic analysis depends only on the pattern, so it runs once per pattern
+// and each compute is only numerical factorization
+template<class Decomposition>
+class DirectPreconditioner : public PreconditionerBase
+{
+public:
+
+    void compute(SparseMatrix const& A) override;
+    void apply(Field<Scalar> const& r, Field<Scalar>& z) const override;
+
+    // Amount of symbolic analyses done so far
+    Index getAnalysisAmount() const;
+
+private:
+
+    Decomposition m_decomposition;
+
+    // Pattern of the analyzed matrix
+    List<Index> m_rowStarts;
+    List<Index> m_columns;
+    Index m_analysisAmount = 0;
+
+    bool samePattern(SparseMatrix const& A) const;
+};
+
+
+// Only for symmetric matrices, definite ones of any sign
+using LDLTPreconditioner = DirectPreconditioner<Eigen::SimplicialLDLT<Eigen::SparseMatrix<Scalar>>>;
+
+using SparseLUPreconditioner = DirectPreconditioner<Eigen::SparseLU<Eigen::SparseMatrix<Scalar>, Eigen::COLAMDOrdering<Index>>>;
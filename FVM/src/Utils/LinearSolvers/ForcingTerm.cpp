@@ -0,0 +1,51 @@
+#include "ForcingTerm.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+ForcingTerm::ForcingTerm(Scalar initialTolerance, Scalar maxTolerance, Scalar gamma, Scalar alpha)
+    : m_initialTolerance(initialTolerance)
+    , m_maxTolerance(maxTolerance)
+    , m_gamma(gamma)
+    , m_alpha(alpha)
+    , m_previousTolerance(initialTolerance)
+{
+    assert(0 < initialTolerance && initialTolerance <= maxTolerance && maxTolerance < 1);
+    assert(0 < gamma && gamma <= 1 && 1 < alpha && alpha <= 2);
+}
+
+
+Scalar ForcingTerm::reset()
+{
+    m_previousResidual = -1;
+    m_previousTolerance = m_initialTolerance;
+    return m_initialTolerance;
+}
+
+
+Scalar ForcingTerm::next(Scalar residual)
+{
+    Scalar tolerance = m_previousTolerance;
+
+    if (m_previousResidual > 0 && std::isfinite(residual))
+    {
+        tolerance = m_gamma * std::pow(residual / m_previousResidual, m_alpha);
+
+        Scalar safeguard = m_gamma * std::pow(m_previousTolerance, m_alpha);
+        if (safeguard > 0.1)
+        {
+            tolerance = std::max(tolerance, safeguard);
+        }
+    }
+
+    tolerance = std::min(tolerance, m_maxTolerance);
+
+    if (std::isfinite(residual))
+    {
+        m_previousResidual = residual;
+    }
+    m_previousTolerance = tolerance;
+    return tolerance;
+}
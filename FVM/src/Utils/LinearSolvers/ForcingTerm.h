@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Utils/Types.h"
+
+
+// Tolerances for inner linear solves of inexact outer iterations,
+// Eisenstat-Walker choice 2: eta_k = gamma * (r_k / r_k-1)^alpha.
+// Solves are loose while the outer residual decreases slowly and tighten
+// when it drops fast, safeguard keeps eta from falling too quickly
+class ForcingTerm
+{
+public:
+
+    ForcingTerm(Scalar initialTolerance = 0.1, Scalar maxTolerance = 0.9, Scalar gamma = 0.9, Scalar alpha = 2);
+
+    // Starts new sequence of outer iterations, returns tolerance for the first one
+    Scalar reset();
+
+    // Tolerance for the next inner solves given residual of the last outer iteration,
+    // ratio of residuals is known only from the second call on
+    Scalar next(Scalar residual);
+
+private:
+
+    Scalar m_initialTolerance;
+    Scalar m_maxTolerance;
+    Scalar m_gamma;
+    Scalar m_alpha;
+
+    // Negative when there is no previous residual
+    Scalar m_previousResidual = -1;
+    Scalar m_previousTolerance;
+};
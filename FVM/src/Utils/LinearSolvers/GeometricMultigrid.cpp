@@ -0,0 +1,219 @@
+#include "GeometricMultigrid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+
+GeometricMultigridPreconditioner::GeometricMultigridPreconditioner
+(
+    Index nx,
+    Index ny,
+    LinearSolvers::MultigridCycle::Type cycleType
+)
+    : m_nx(nx)
+    , m_ny(ny)
+    , m_cycleType(cycleType)
+{}
+
+
+// Cells are colored by parity of x + y
+static bool isRedBlack(SparseMatrix const& A, Index nx)
+{
+    for (Index row = 0; row < A.outerSize(); row++)
+    {
+        for (SparseMatrix::InnerIterator iter(A, row); iter; ++iter)
+        {
+            Index col = iter.col();
+            bool sameColor = (row / nx + row % nx) % 2 == (col / nx + col % nx) % 2;
+            if (col != row && sameColor)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+void GeometricMultigridPreconditioner::compute(SparseMatrix const& A)
+{
+    if (A.rows() != m_nx * m_ny || A.cols() != m_nx * m_ny)
+    {
+        throw std::invalid_argument("Matrix size doesn't match the grid\n");
+    }
+
+    // Transfer operators depend only on the grid, so they are built once
+    if (m_levels.empty())
+    {
+        buildTransfers();
+    }
+
+    SparseMatrix current = A;
+    for (Level& level : m_levels)
+    {
+        MultigridOperators<Scalar>& operators = level.operators;
+        operators.A = std::move(current);
+        operators.A.makeCompressed();
+        level.redBlack = isRedBlack(operators.A, level.nx);
+        level.computeInverseDiagonal();
+
+        // Merging cells doubles face coefficients of 2D diffusion operator,
+        // halved Galerkin product matches rediscretization on the coarse grid
+        SparseMatrix AP = operators.A * operators.P;
+        current = 0.5 * (operators.R * AP);
+
+        if (m_singlePrecision)
+        {
+            level.computeSingleOperators();
+        }
+    }
+
+    m_coarsestSolver.compute(current);
+}
+
+
+void GeometricMultigridPreconditioner::buildTransfers()
+{
+    Index nx = m_nx;
+    Index ny = m_ny;
+
+    while (nx * ny > coarsestSize && nx > 1 && ny > 1)
+    {
+        // On odd size the last coarse cell merges three fine cells.
+        // Larger coarse cell only underestimates the correction,
+        // while a single child cell overestimates it and V-cycle diverges
+        Index coarseNx = nx / 2;
+        Index coarseNy = ny / 2;
+
+        List<Eigen::Triplet<Scalar>> triplets;
+        triplets.reserve(nx * ny);
+        for (Index y = 0; y < ny; y++)
+        {
+            for (Index x = 0; x < nx; x++)
+            {
+                Index coarseX = std::min(x/2, coarseNx - 1);
+                Index coarseY = std::min(y/2, coarseNy - 1);
+                triplets.emplace_back(coarseY * coarseNx + coarseX, y*nx + x, 1);
+            }
+        }
+
+        Level& level = m_levels.emplace_back();
+        level.nx = nx;
+        level.ny = ny;
+        level.operators.R = SparseMatrix(coarseNx * coarseNy, nx * ny);
+        level.operators.R.setFromTriplets(triplets.begin(), triplets.end());
+        level.operators.P = level.operators.R.transpose();
+
+        nx = coarseNx;
+        ny = coarseNy;
+    }
+}
+
+
+void GeometricMultigridPreconditioner::apply(Field<Scalar> const& r, Field<Scalar>& z) const
+{
+    z.setZero(r.rows());
+    cycle(0, m_cycleType, r, z);
+}
+
+
+void GeometricMultigridPreconditioner::applySingle(Field<float> const& r, Field<float>& z) const
+{
+    z.setZero(r.rows());
+    cycle(0, m_cycleType, r, z);
+}
+
+
+Index GeometricMultigridPreconditioner::getLevelAmount() const
+{
+    return m_levels.size() + 1;
+}
+
+
+template<class T>
+void GeometricMultigridPreconditioner::smooth(Level const& level, Field<T> const& b, Field<T>& x, bool forward) const
+{
+    auto const& operators = level.operatorsOf<T>();
+    Field<T> const& inverseDiagonal = operators.inverseDiagonal;
+    T const* values = operators.A.valuePtr();
+    Index const* columns = operators.A.innerIndexPtr();
+    Index const* rowStarts = operators.A.outerIndexPtr();
+
+    for (Index colorIdx = 0; colorIdx < 2; colorIdx++)
+    {
+        Index color = forward ? colorIdx : 1 - colorIdx;
+
+#ifdef _OPENMP
+        #pragma omp parallel for if(level.redBlack)
+#endif
+        for (Index y = 0; y < level.ny; y++)
+        {
+            for (Index x0 = (y + color) % 2; x0 < level.nx; x0 += 2)
+            {
+                Index row = y * level.nx + x0;
+
+                T residual = b(row);
+                for (Index pos = rowStarts[row]; pos < rowStarts[row+1]; pos++)
+                {
+                    residual -= values[pos] * x(columns[pos]);
+                }
+                x(row) += residual * inverseDiagonal(row);
+            }
+        }
+    }
+}
+
+
+template<class T>
+void GeometricMultigridPreconditioner::cycle
+(
+    Index levelIdx,
+    LinearSolvers::MultigridCycle::Type cycleType,
+    Field<T> const& b,
+    Field<T>& x
+) const
+{
+    using namespace LinearSolvers::MultigridCycle;
+
+    if (levelIdx == Index(m_levels.size()))
+    {
+        m_coarsestSolver.solve(b, x);
+        return;
+    }
+
+    Level const& level = m_levels[levelIdx];
+    auto const& [A, inverseDiagonal, P, R] = level.operatorsOf<T>();
+
+    for (Index step = 0; step < smoothingSteps; step++)
+    {
+        smooth(level, b, x, true);
+    }
+
+    Field<T> coarseB = R * (b - A * x);
+    Field<T> coarseX = Field<T>::Zero(coarseB.rows());
+
+    switch (cycleType)
+    {
+    case V:
+        cycle(levelIdx + 1, V, coarseB, coarseX);
+        break;
+
+    case W:
+        cycle(levelIdx + 1, W, coarseB, coarseX);
+        cycle(levelIdx + 1, W, coarseB, coarseX);
+        break;
+
+    case F:
+        cycle(levelIdx + 1, F, coarseB, coarseX);
+        cycle(levelIdx + 1, V, coarseB, coarseX);
+        break;
+    }
+
+    x += P * coarseX;
+
+    for (Index step = 0; step < smoothingSteps; step++)
+    {
+        smooth(level, b, x, false);
+    }
+}
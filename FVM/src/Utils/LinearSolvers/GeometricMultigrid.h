@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Utils/Types.h"
+#include "LinearSolverTypes.h"
+#include "Preconditioners.h"
+#include "MultigridLevel.h"
+
+
+// Multigrid on structured nx x ny grid, cell index is y*nx + x.
+// Coarse cells merge 2x2 fine cells, restriction sums children and
+// prolongation is constant over them, so Galerkin coarse operators keep
+// the 5-point stencil and red-black Gauss-Seidel is exact on every level.
+// V and W cycles are symmetric and fit CG, F cycle fits other solvers
+class GeometricMultigridPreconditioner : public PreconditionerBase
+{
+public:
+
+    GeometricMultigridPreconditioner
+    (
+        Index nx,
+        Index ny,
+        LinearSolvers::MultigridCycle::Type cycleType = LinearSolvers::MultigridCycle::V
+    );
+
+    void compute(SparseMatrix const& A) override;
+    void apply(Field<Scalar> const& r, Field<Scalar>& z) const override;
+    void applySingle(Field<float> const& r, Field<float>& z) const override;
+
+    Index getLevelAmount() const;
+
+private:
+
+    static constexpr Index coarsestSize = 64;
+    static constexpr Index smoothingSteps = 2;
+
+    struct Level : MultigridLevel
+    {
+        Index nx = 0;
+        Index ny = 0;
+        // No couplings between cells of the same color, so each color is updated in parallel
+        bool redBlack = false;
+    };
+
+    Index m_nx;
+    Index m_ny;
+    LinearSolvers::MultigridCycle::Type m_cycleType;
+
+    List<Level> m_levels;
+    MultigridCoarsestSolver m_coarsestSolver;
+
+    void buildTransfers();
+
+    // Forward sweep updates red cells first, backward sweep black cells first
+    template<class T>
+    void smooth(Level const& level, Field<T> const& b, Field<T>& x, bool forward) const;
+
+    template<class T>
+    void cycle(Index levelIdx, LinearSolvers::MultigridCycle::Type cycleType, Field<T> const& b, Field<T>& x) const;
+};
@@ -0,0 +1,859 @@
+#include "KrylovSolvers.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+
+template<class T>
+using DenseMatrix = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+
+
+// Single precision uses float copies kept by preconditioner
+template<class T>
+static void applyPreconditioner(PreconditionerBase const& preconditioner, std::type_identity_t<Field<T>> const& r, Field<T>& z)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        preconditioner.applySingle(r, z);
+    }
+    else
+    {
+        preconditioner.apply(r, z);
+    }
+}
+
+
+template<class T>
+static Field<T> residual(SparseOperator const& A, Field<T> const& b, Field<T> const& x)
+{
+    Field<T> r;
+    A.multiply(x, r);
+    r = b - r;
+    return r;
+}
+
+
+void KrylovSolverBase::setTolerance(Scalar tolerance)
+{
+    m_tolerance = tolerance;
+}
+
+
+void KrylovSolverBase::setMaxIterations(Index maxIterations)
+{
+    m_maxIterations = maxIterations;
+}
+
+
+bool KrylovSolverBase::solveSingle
+(
+    SparseOperator const&,
+    PreconditionerBase const&,
+    Field<float> const&,
+    Field<float>&
+)
+{
+    throw std::logic_error("Linear solver has no single precision version\n");
+}
+
+
+bool KrylovSolverBase::solveBlock
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Matrix const& B,
+    Matrix& X
+)
+{
+    assert(B.rows() == X.rows() && B.cols() == X.cols());
+
+    bool converged = true;
+    Index iterations = 0;
+    Scalar error = 0;
+
+    Field<Scalar> x;
+    for (Index col = 0; col < B.cols(); col++)
+    {
+        x = X.col(col);
+        converged &= solve(A, preconditioner, B.col(col), x);
+        X.col(col) = x;
+        iterations = std::max(iterations, m_iterations);
+        error = std::max(error, m_error);
+    }
+
+    m_iterations = iterations;
+    m_error = error;
+    return converged;
+}
+
+
+Index KrylovSolverBase::iterations() const
+{
+    return m_iterations;
+}
+
+
+Scalar KrylovSolverBase::error() const
+{
+    return m_error;
+}
+
+
+Index KrylovSolverBase::maxIterations(SparseOperator const& A) const
+{
+    return m_maxIterations > 0 ? m_maxIterations : 2 * A.rows();
+}
+
+
+bool ConjugateGradientSolver::solve
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<Scalar> const& b,
+    Field<Scalar>& x
+)
+{
+    return iterate(A, preconditioner, b, x);
+}
+
+
+bool ConjugateGradientSolver::solveSingle
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<float> const& b,
+    Field<float>& x
+)
+{
+    return iterate(A, preconditioner, b, x);
+}
+
+
+template<class T>
+bool ConjugateGradientSolver::iterate
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<T> const& b,
+    Field<T>& x
+)
+{
+    assert(A.rows() == A.cols() && A.rows() == b.rows() && A.rows() == x.rows());
+
+    m_iterations = 0;
+    m_error = 0;
+
+    T bNorm = b.norm();
+    if (bNorm == 0)
+    {
+        x.setZero();
+        return true;
+    }
+
+    Index maxIter = maxIterations(A);
+
+    Field<T> r = residual(A, b, x);
+    m_error = r.norm() / bNorm;
+
+    Field<T> z, p, Ap;
+    applyPreconditioner(preconditioner, r, z);
+    p = z;
+    T rz = r.dot(z);
+
+    while (m_error > m_tolerance && m_iterations < maxIter)
+    {
+        A.multiply(p, Ap);
+        T pAp = p.dot(Ap);
+        if (pAp == 0)
+        {
+            break;
+        }
+
+        T alpha = rz / pAp;
+        x += alpha * p;
+        r -= alpha * Ap;
+
+        m_iterations++;
+        m_error = r.norm() / bNorm;
+
+        applyPreconditioner(preconditioner, r, z);
+        T rzNew = r.dot(z);
+        p = z + (rzNew / rz) * p;
+        rz = rzNew;
+    }
+
+    return m_error <= m_tolerance;
+}
+
+bool ConjugateGradientSolver::solveBlock
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Matrix const& B,
+    Matrix& X
+)
+{
+    assert(A.rows() == A.cols() && A.rows() == B.rows());
+    assert(B.rows() == X.rows() && B.cols() == X.cols());
+
+    Index size = A.rows();
+    Index columnAmount = B.cols();
+    Index maxIter = maxIterations(A);
+
+    m_iterations = 0;
+
+    Matrix AX;
+    A.multiply(X, AX);
+    Matrix R = B - AX;
+
+    Field<Scalar> bNorm = B.colwise().norm().transpose();
+    Field<Scalar> error = Field<Scalar>::Zero(columnAmount);
+    Field<Scalar> rz = Field<Scalar>::Zero(columnAmount);
+    List<bool> active(columnAmount, false);
+
+    Matrix Z = Matrix::Zero(size, columnAmount);
+    Matrix AP;
+    Field<Scalar> z;
+
+    for (Index col = 0; col < columnAmount; col++)
+    {
+        if (bNorm(col) == 0)
+        {
+            X.col(col).setZero();
+            continue;
+        }
+        error(col) = R.col(col).norm() / bNorm(col);
+        active[col] = error(col) > m_tolerance;
+
+        preconditioner.apply(R.col(col), z);
+        Z.col(col) = z;
+        rz(col) = R.col(col).dot(z);
+    }
+    Matrix P = Z;
+
+    auto anyActive = [&active]()
+    {
+        return std::find(active.begin(), active.end(), true) != active.end();
+    };
+
+    while (anyActive() && m_iterations < maxIter)
+    {
+        // Converged columns are multiplied too, it costs less than reading the matrix again
+        A.multiply(P, AP);
+        m_iterations++;
+
+        for (Index col = 0; col < columnAmount; col++)
+        {
+            if (!active[col])
+            {
+                continue;
+            }
+
+            Scalar pAp = P.col(col).dot(AP.col(col));
+            if (pAp == 0)
+            {
+                active[col] = false;
+                continue;
+            }
+
+            Scalar alpha = rz(col) / pAp;
+            X.col(col) += alpha * P.col(col);
+            R.col(col) -= alpha * AP.col(col);
+
+            error(col) = R.col(col).norm() / bNorm(col);
+            if (error(col) <= m_tolerance)
+            {
+                active[col] = false;
+                continue;
+            }
+
+            preconditioner.apply(R.col(col), z);
+            Scalar rzNew = R.col(col).dot(z);
+            P.col(col) = z + (rzNew / rz(col)) * P.col(col);
+            rz(col) = rzNew;
+        }
+    }
+
+    m_error = error.maxCoeff();
+    return m_error <= m_tolerance;
+}
+
+
+bool BiCGSTABSolver::solve
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<Scalar> const& b,
+    Field<Scalar>& x
+)
+{
+    return iterate(A, preconditioner, b, x);
+}
+
+
+bool BiCGSTABSolver::solveSingle
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<float> const& b,
+    Field<float>& x
+)
+{
+    return iterate(A, preconditioner, b, x);
+}
+
+
+template<class T>
+bool BiCGSTABSolver::iterate
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<T> const& b,
+    Field<T>& x
+)
+{
+    assert(A.rows() == A.cols() && A.rows() == b.rows() && A.rows() == x.rows());
+
+    m_iterations = 0;
+    m_error = 0;
+
+    T bNorm = b.norm();
+    if (bNorm == 0)
+    {
+        x.setZero();
+        return true;
+    }
+
+    Index size = A.rows();
+    Index maxIter = maxIterations(A);
+    constexpr T eps2 = std::numeric_limits<T>::epsilon() * std::numeric_limits<T>::epsilon();
+
+    Field<T> r = residual(A, b, x);
+    Field<T> r0 = r;
+    T r0SqNorm = r0.squaredNorm();
+    m_error = r.norm() / bNorm;
+
+    Field<T> p = Field<T>::Zero(size);
+    Field<T> v = Field<T>::Zero(size);
+    Field<T> y, z, s, t;
+    T rho = 1, alpha = 1, omega = 1;
+
+    while (m_error > m_tolerance && m_iterations < maxIter)
+    {
+        T rhoOld = rho;
+        rho = r0.dot(r);
+
+        // Shadow residual became orthogonal to residual, restarting
+        if (std::abs(rho) < eps2 * r0SqNorm)
+        {
+            r = residual(A, b, x);
+            r0 = r;
+            rho = r0SqNorm = r.squaredNorm();
+            p.setZero();
+            v.setZero();
+            rhoOld = alpha = omega = 1;
+        }
+
+        T beta = (rho / rhoOld) * (alpha / omega);
+        p = r + beta * (p - omega * v);
+
+        applyPreconditioner(preconditioner, p, y);
+        A.multiply(y, v);
+
+        T r0v = r0.dot(v);
+        if (r0v == 0)
+        {
+            break;
+        }
+        alpha = rho / r0v;
+        s = r - alpha * v;
+
+        m_iterations++;
+
+        if (s.norm() / bNorm <= m_tolerance)
+        {
+            x += alpha * y;
+            r = s;
+            m_error = r.norm() / bNorm;
+            break;
+        }
+
+        applyPreconditioner(preconditioner, s, z);
+        A.multiply(z, t);
+
+        T tt = t.squaredNorm();
+        if (tt == 0)
+        {
+            break;
+        }
+        omega = t.dot(s) / tt;
+
+        x += alpha * y + omega * z;
+        r = s - omega * t;
+        m_error = r.norm() / bNorm;
+    }
+
+    return m_error <= m_tolerance;
+}
+
+bool BiCGSTABSolver::solveBlock
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Matrix const& B,
+    Matrix& X
+)
+{
+    assert(A.rows() == A.cols() && A.rows() == B.rows());
+    assert(B.rows() == X.rows() && B.cols() == X.cols());
+
+    Index size = A.rows();
+    Index columnAmount = B.cols();
+    Index maxIter = maxIterations(A);
+    constexpr Scalar eps2 = std::numeric_limits<Scalar>::epsilon() * std::numeric_limits<Scalar>::epsilon();
+
+    m_iterations = 0;
+
+    Matrix AX;
+    A.multiply(X, AX);
+    Matrix R = B - AX;
+    Matrix R0 = R;
+
+    Field<Scalar> bNorm = B.colwise().norm().transpose();
+    Field<Scalar> r0SqNorm = R0.colwise().squaredNorm().transpose();
+    Field<Scalar> error = Field<Scalar>::Zero(columnAmount);
+    List<bool> active(columnAmount, false);
+
+    for (Index col = 0; col < columnAmount; col++)
+    {
+        if (bNorm(col) == 0)
+        {
+            X.col(col).setZero();
+            continue;
+        }
+        error(col) = R.col(col).norm() / bNorm(col);
+        active[col] = error(col) > m_tolerance;
+    }
+
+    Matrix P = Matrix::Zero(size, columnAmount);
+    Matrix V = Matrix::Zero(size, columnAmount);
+    Matrix Y = Matrix::Zero(size, columnAmount);
+    Matrix Z = Matrix::Zero(size, columnAmount);
+    Matrix S = Matrix::Zero(size, columnAmount);
+    Matrix T;
+    Field<Scalar> rho = Field<Scalar>::Ones(columnAmount);
+    Field<Scalar> alpha = Field<Scalar>::Ones(columnAmount);
+    Field<Scalar> omega = Field<Scalar>::Ones(columnAmount);
+    Field<Scalar> y, z;
+
+    auto anyActive = [&active]()
+    {
+        return std::find(active.begin(), active.end(), true) != active.end();
+    };
+
+    // Converged columns are multiplied too, it costs less than reading the matrix again
+    while (anyActive() && m_iterations < maxIter)
+    {
+        for (Index col = 0; col < columnAmount; col++)
+        {
+            if (!active[col])
+            {
+                continue;
+            }
+
+            Scalar rhoOld = rho(col);
+            rho(col) = R0.col(col).dot(R.col(col));
+
+            // Shadow residual became orthogonal to residual, restarting
+            if (std::abs(rho(col)) < eps2 * r0SqNorm(col))
+            {
+                R.col(col) = B.col(col) - A * X.col(col);
+                R0.col(col) = R.col(col);
+                rho(col) = r0SqNorm(col) = R.col(col).squaredNorm();
+                P.col(col).setZero();
+                V.col(col).setZero();
+                rhoOld = alpha(col) = omega(col) = 1;
+            }
+
+            Scalar beta = (rho(col) / rhoOld) * (alpha(col) / omega(col));
+            P.col(col) = R.col(col) + beta * (P.col(col) - omega(col) * V.col(col));
+
+            preconditioner.apply(P.col(col), y);
+            Y.col(col) = y;
+        }
+
+        A.multiply(Y, V);
+        m_iterations++;
+
+        for (Index col = 0; col < columnAmount; col++)
+        {
+            if (!active[col])
+            {
+                continue;
+            }
+
+            Scalar r0v = R0.col(col).dot(V.col(col));
+            if (r0v == 0)
+            {
+                active[col] = false;
+                continue;
+            }
+            alpha(col) = rho(col) / r0v;
+            S.col(col) = R.col(col) - alpha(col) * V.col(col);
+
+            if (S.col(col).norm() / bNorm(col) <= m_tolerance)
+            {
+                X.col(col) += alpha(col) * Y.col(col);
+                R.col(col) = S.col(col);
+                error(col) = R.col(col).norm() / bNorm(col);
+                active[col] = false;
+                continue;
+            }
+
+            preconditioner.apply(S.col(col), z);
+            Z.col(col) = z;
+        }
+
+        if (!anyActive())
+        {
+            break;
+        }
+
+        A.multiply(Z, T);
+
+        for (Index col = 0; col < columnAmount; col++)
+        {
+            if (!active[col])
+            {
+                continue;
+            }
+
+            Scalar tt = T.col(col).squaredNorm();
+            if (tt == 0)
+            {
+                active[col] = false;
+                continue;
+            }
+            omega(col) = T.col(col).dot(S.col(col)) / tt;
+
+            X.col(col) += alpha(col) * Y.col(col) + omega(col) * Z.col(col);
+            R.col(col) = S.col(col) - omega(col) * T.col(col);
+            error(col) = R.col(col).norm() / bNorm(col);
+            active[col] = error(col) > m_tolerance;
+        }
+    }
+
+    m_error = error.maxCoeff();
+    return m_error <= m_tolerance;
+}
+
+
+GMRESSolver::GMRESSolver(Index restart) : m_restart(restart)
+{
+    assert(restart > 0);
+}
+
+
+bool GMRESSolver::solve
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<Scalar> const& b,
+    Field<Scalar>& x
+)
+{
+    return iterate(A, preconditioner, b, x);
+}
+
+
+bool GMRESSolver::solveSingle
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<float> const& b,
+    Field<float>& x
+)
+{
+    return iterate(A, preconditioner, b, x);
+}
+
+
+template<class T>
+bool GMRESSolver::iterate
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<T> const& b,
+    Field<T>& x
+)
+{
+    assert(A.rows() == A.cols() && A.rows() == b.rows() && A.rows() == x.rows());
+
+    m_iterations = 0;
+    m_error = 0;
+
+    T bNorm = b.norm();
+    if (bNorm == 0)
+    {
+        x.setZero();
+        return true;
+    }
+
+    Index size = A.rows();
+    Index maxIter = maxIterations(A);
+    Index restart = std::min(m_restart, size);
+
+    // Arnoldi basis and Hessenberg matrix reduced by Givens rotations
+    DenseMatrix<T> basis(size, restart + 1);
+    DenseMatrix<T> hessenberg(restart + 1, restart);
+    Field<T> cosines(restart), sines(restart), g(restart + 1);
+    Field<T> z, w;
+
+    Field<T> r = residual(A, b, x);
+    m_error = r.norm() / bNorm;
+
+    while (m_error > m_tolerance && m_iterations < maxIter)
+    {
+        T beta = r.norm();
+        basis.col(0) = r / beta;
+        g.setZero();
+        g(0) = beta;
+
+        Index cycleSize = 0;
+        while (cycleSize < restart && m_iterations < maxIter)
+        {
+            Index j = cycleSize;
+
+            applyPreconditioner(preconditioner, basis.col(j), z);
+            A.multiply(z, w);
+
+            // Modified Gram-Schmidt
+            for (Index i = 0; i <= j; i++)
+            {
+                hessenberg(i, j) = w.dot(basis.col(i));
+                w -= hessenberg(i, j) * basis.col(i);
+            }
+            T wNorm = w.norm();
+            hessenberg(j+1, j) = wNorm;
+            if (wNorm != 0)
+            {
+                basis.col(j+1) = w / wNorm;
+            }
+
+            for (Index i = 0; i < j; i++)
+            {
+                T tmp = cosines(i) * hessenberg(i, j) + sines(i) * hessenberg(i+1, j);
+                hessenberg(i+1, j) = -sines(i) * hessenberg(i, j) + cosines(i) * hessenberg(i+1, j);
+                hessenberg(i, j) = tmp;
+            }
+
+            T denom = std::hypot(hessenberg(j, j), hessenberg(j+1, j));
+            if (denom == 0)
+            {
+                break;
+            }
+            cosines(j) = hessenberg(j, j) / denom;
+            sines(j) = hessenberg(j+1, j) / denom;
+            hessenberg(j, j) = denom;
+            hessenberg(j+1, j) = 0;
+
+            g(j+1) = -sines(j) * g(j);
+            g(j) *= cosines(j);
+
+            cycleSize++;
+            m_iterations++;
+
+            // Exact solution is in the subspace on zero norm
+            if (std::abs(g(j+1)) / bNorm <= m_tolerance || wNorm == 0)
+            {
+                break;
+            }
+        }
+
+        if (cycleSize == 0)
+        {
+            break;
+        }
+
+        Field<T> coeffs = hessenberg.topLeftCorner(cycleSize, cycleSize)
+            .template triangularView<Eigen::Upper>().solve(g.head(cycleSize));
+
+        applyPreconditioner(preconditioner, basis.leftCols(cycleSize) * coeffs, z);
+        x += z;
+
+        r = residual(A, b, x);
+        m_error = r.norm() / bNorm;
+    }
+
+    return m_error <= m_tolerance;
+}
+
+
+bool RichardsonSolver::solve
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<Scalar> const& b,
+    Field<Scalar>& x
+)
+{
+    return iterate(A, preconditioner, b, x);
+}
+
+
+bool RichardsonSolver::solveSingle
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<float> const& b,
+    Field<float>& x
+)
+{
+    return iterate(A, preconditioner, b, x);
+}
+
+
+template<class T>
+bool RichardsonSolver::iterate
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<T> const& b,
+    Field<T>& x
+)
+{
+    assert(A.rows() == A.cols() && A.rows() == b.rows() && A.rows() == x.rows());
+
+    m_iterations = 0;
+    m_error = 0;
+
+    T bNorm = b.norm();
+    if (bNorm == 0)
+    {
+        x.setZero();
+        return true;
+    }
+
+    Index maxIter = maxIterations(A);
+
+    Field<T> r = residual(A, b, x);
+    Field<T> z;
+    m_error = r.norm() / bNorm;
+
+    while (m_error > m_tolerance && m_iterations < maxIter)
+    {
+        applyPreconditioner(preconditioner, r, z);
+        x += z;
+        Field<T> newResidual = residual(A, b, x);
+
+        m_iterations++;
+
+        // Exact preconditioners stop at rounding level, which may be above tolerance,
+        // stale ones may diverge. Step which didn't decrease the residual is taken back
+        Scalar error = newResidual.norm() / bNorm;
+        if (error >= m_error)
+        {
+            x -= z;
+            break;
+        }
+        r = std::move(newResidual);
+        m_error = error;
+    }
+
+    return m_error <= m_tolerance;
+}
+
+
+MixedPrecisionSolver::MixedPrecisionSolver(std::unique_ptr<KrylovSolverBase> innerSolver, Scalar innerTolerance)
+    : m_innerSolver(std::move(innerSolver))
+    , m_innerTolerance(innerTolerance)
+{
+    assert(m_innerSolver);
+}
+
+
+bool MixedPrecisionSolver::solve
+(
+    SparseOperator const& A,
+    PreconditionerBase const& preconditioner,
+    Field<Scalar> const& b,
+    Field<Scalar>& x
+)
+{
+    assert(A.rows() == A.cols() && A.rows() == b.rows() && A.rows() == x.rows());
+
+    m_iterations = 0;
+    m_error = 0;
+
+    Scalar bNorm = b.norm();
+    if (bNorm == 0)
+    {
+        x.setZero();
+        return true;
+    }
+
+    Index maxIter = maxIterations(A);
+    // Refinement stagnates at rounding level of double residual, so it stops at the cap,
+    // but convergence is still reported against the requested tolerance
+    Scalar tolerance = std::max(m_tolerance, minRefinementTolerance);
+    m_innerSolver->setTolerance(std::max(tolerance, m_innerTolerance));
+    m_innerSolver->setMaxIterations(maxIter);
+
+    Field<Scalar> r = residual(A, b, x);
+    Field<float> correction;
+    m_error = r.norm() / bNorm;
+
+    while (m_error > tolerance && m_iterations < maxIter)
+    {
+        // Scaled residual keeps float away from underflow near convergence
+        Scalar rNorm = r.norm();
+        Field<float> rSingle = (r / rNorm).cast<float>();
+        correction = Field<float>::Zero(r.rows());
+
+        m_innerSolver->solveSingle(A, preconditioner, rSingle, correction);
+        m_iterations += std::max(m_innerSolver->iterations(), 1);
+
+        Field<Scalar> scaledCorrection = rNorm * correction.cast<Scalar>();
+        x += scaledCorrection;
+        Field<Scalar> newResidual = residual(A, b, x);
+
+        // Refinement stagnates when float cannot resolve the correction,
+        // correction which didn't decrease the residual is taken back
+        Scalar error = newResidual.norm() / bNorm;
+        if (error >= m_error)
+        {
+            x -= scaledCorrection;
+            break;
+        }
+        r = std::move(newResidual);
+        m_error = error;
+    }
+
+    return m_error <= m_tolerance;
+}
+
+
+std::unique_ptr<KrylovSolverBase> makeKrylovSolver(LinearSolvers::Solver::Type type)
+{
+    using namespace LinearSolvers::Solver;
+
+    switch (type)
+    {
+    case CG:
+        return std::make_unique<ConjugateGradientSolver>();
+
+    case BICGSTAB:
+        return std::make_unique<BiCGSTABSolver>();
+
+    case GMRES:
+        return std::make_unique<GMRESSolver>();
+
+    case RICHARDSON:
+        return std::make_unique<RichardsonSolver>();
+    }
+
+    throw std::invalid_argument("Unknown linear solver type\n");
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Utils/Types.h"
+#include "LinearSolverTypes.h"
+#include "Preconditioners.h"
+#include "SparseOperator.h"
+
+#include <limits>
+#include <memory>
+
+
+class KrylovSolverBase
+{
+public:
+
+    virtual ~KrylovSolverBase() = default;
+
+    // Stops when ||b - Ax|| <= tolerance * ||b||
+    void setTolerance(Scalar tolerance);
+
+    // Non positive value means twice the matrix size
+    void setMaxIterations(Index maxIterations);
+
+    // x is used as the initial guess, returns true if converged
+    virtual bool solve
+    (
+        SparseOperator const& A,
+        PreconditionerBase const& preconditioner,
+        Field<Scalar> const& b,
+        Field<Scalar>& x
+    ) = 0;
+
+    // Same in single precision, used as inner solve of mixed precision solver
+    virtual bool solveSingle
+    (
+        SparseOperator const& A,
+        PreconditionerBase const& preconditioner,
+        Field<float> const& b,
+        Field<float>& x
+    );
+
+    // Columns of B are separate systems with the same matrix, X is the initial guess.
+    // By default they are solved one by one
+    virtual bool solveBlock
+    (
+        SparseOperator const& A,
+        PreconditionerBase const& preconditioner,
+        Matrix const& B,
+        Matrix& X
+    );
+
+    // Statistics of the last solve, maximum over columns for block solve
+    Index iterations() const;
+    Scalar error() const;
+
+protected:
+
+    Scalar m_tolerance = std::numeric_limits<Scalar>::epsilon();
+    Index m_maxIterations = 0;
+
+    Index m_iterations = 0;
+    Scalar m_error = 0;
+
+    Index maxIterations(SparseOperator const& A) const;
+};
+
+
+// Preconditioned conjugate gradient, preconditioner should be symmetric.
+// Block solve advances all columns together, so each iteration reads the matrix once
+class ConjugateGradientSolver : public KrylovSolverBase
+{
+public:
+
+    bool solve(SparseOperator const&, PreconditionerBase const&, Field<Scalar> const&, Field<Scalar>&) override;
+    bool solveSingle(SparseOperator const&, PreconditionerBase const&, Field<float> const&, Field<float>&) override;
+    bool solveBlock(SparseOperator const&, PreconditionerBase const&, Matrix const&, Matrix&) override;
+
+private:
+
+    template<class T>
+    bool iterate(SparseOperator const&, PreconditionerBase const&, Field<T> const&, Field<T>&);
+};
+
+
+// Right preconditioned BiCGSTAB, restarts on breakdown.
+// Block solve advances all columns together, so each iteration reads the matrix once
+class BiCGSTABSolver : public KrylovSolverBase
+{
+public:
+
+    bool solve(SparseOperator const&, PreconditionerBase const&, Field<Scalar> const&, Field<Scalar>&) override;
+    bool solveSingle(SparseOperator const&, PreconditionerBase const&, Field<float> const&, Field<float>&) override;
+    bool solveBlock(SparseOperator const&, PreconditionerBase const&, Matrix const&, Matrix&) override;
+
+private:
+
+    template<class T>
+    bool iterate(SparseOperator const&, PreconditionerBase const&, Field<T> const&, Field<T>&);
+};
+
+
+// Right preconditioned GMRES(m)
+class GMRESSolver : public KrylovSolverBase
+{
+public:
+
+    explicit GMRESSolver(Index restart = 30);
+
+    bool solve(SparseOperator const&, PreconditionerBase const&, Field<Scalar> const&, Field<Scalar>&) override;
+    bool solveSingle(SparseOperator const&, PreconditionerBase const&, Field<float> const&, Field<float>&) override;
+
+private:
+
+    Index m_restart;
+
+    template<class T>
+    bool iterate(SparseOperator const&, PreconditionerBase const&, Field<T> const&, Field<T>&);
+};
+
+
+// Not a Krylov method, but shares the interface,
+// useful when preconditioner is good enough on its own.
+// Stops when the residual no longer decreases
+class RichardsonSolver : public KrylovSolverBase
+{
+public:
+
+    bool solve(SparseOperator const&, PreconditionerBase const&, Field<Scalar> const&, Field<Scalar>&) override;
+    bool solveSingle(SparseOperator const&, PreconditionerBase const&, Field<float> const&, Field<float>&) override;
+
+private:
+
+    template<class T>
+    bool iterate(SparseOperator const&, PreconditionerBase const&, Field<T> const&, Field<T>&);
+};
+
+
+// Iterative refinement: residual and solution are updated in double,
+// corrections are found by the inner solver in single precision with relative
+// tolerance innerTolerance. Matrix products and preconditioner work on float copies,
+// so SparseOperator and preconditioner should have single precision enabled
+class MixedPrecisionSolver : public KrylovSolverBase
+{
+public:
+
+    explicit MixedPrecisionSolver(std::unique_ptr<KrylovSolverBase> innerSolver, Scalar innerTolerance = 1e-3);
+
+    bool solve(SparseOperator const&, PreconditionerBase const&, Field<Scalar> const&, Field<Scalar>&) override;
+
+private:
+
+    std::unique_ptr<KrylovSolverBase> m_innerSolver;
+    Scalar m_innerTolerance;
+
+    // Iterations stop at it, residual computed in double stops decreasing around it.
+    // Tighter requested tolerance is reported as not converged
+    static constexpr Scalar minRefinementTolerance = 1e3 * std::numeric_limits<Scalar>::epsilon();
+};
+
+
+std::unique_ptr<KrylovSolverBase> makeKrylovSolver(LinearSolvers::Solver::Type type);
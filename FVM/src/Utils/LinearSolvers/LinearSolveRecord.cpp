@@ -0,0 +1,55 @@
+#include "LinearSolveRecord.h"
+
+#include <limits>
+#include <stdexcept>
+
+
+void LinearSolveSummary::add(LinearSolveRecord const& record)
+{
+    solveAmount++;
+    totalIterations += record.iterations;
+    unconvergedAmount += !record.converged;
+    setupTime += record.setupTime;
+    solveTime += record.solveTime;
+    last = record;
+}
+
+
+LinearSolveLog::LinearSolveLog(std::string const& path)
+{
+    if (path.empty())
+    {
+        return;
+    }
+
+    m_file.open(path);
+    if (!m_file)
+    {
+        throw std::runtime_error("Can't open linear solve log " + path + "\n");
+    }
+
+    m_file.precision(std::numeric_limits<Scalar>::max_digits10);
+    m_file << "equation,time,outer_iteration,iterations,error,converged,preconditioner_updated,setup_time,solve_time\n";
+}
+
+
+bool LinearSolveLog::isOpen() const
+{
+    return m_file.is_open();
+}
+
+
+void LinearSolveLog::write(std::string const& equation, Scalar time, Index outerIteration, LinearSolveRecord const& record)
+{
+    if (!isOpen())
+    {
+        return;
+    }
+
+    m_file << equation << ',' << time << ',' << outerIteration << ','
+        << record.iterations << ',' << record.error << ','
+        << record.converged << ',' << record.preconditionerUpdated << ','
+        << record.setupTime << ',' << record.solveTime << '\n';
+    // Log is followed during long runs
+    m_file.flush();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Utils/Types.h"
+
+#include <fstream>
+#include <string>
+
+
+// Statistics of one linear solve
+struct LinearSolveRecord
+{
+    Index iterations = 0;
+    // Right hand side columns solved together
+    Index columns = 0;
+    // Relative residual ||b - Ax|| / ||b||, maximum over rhs columns
+    Scalar error = 0;
+    bool converged = true;
+    bool preconditionerUpdated = false;
+    // Seconds spent on preconditioner and matrix setup and on the iterations
+    double setupTime = 0;
+    double solveTime = 0;
+};
+
+
+// Running totals of the solves of one equation, the full history is left to the log
+struct LinearSolveSummary
+{
+    Index solveAmount = 0;
+    Index totalIterations = 0;
+    Index unconvergedAmount = 0;
+    double setupTime = 0;
+    double solveTime = 0;
+    LinearSolveRecord last;
+
+    void add(LinearSolveRecord const& record);
+};
+
+
+// CSV log of linear solves, one line per solve
+class LinearSolveLog
+{
+public:
+
+    // Empty path disables the log
+    explicit LinearSolveLog(std::string const& path = "");
+
+    bool isOpen() const;
+
+    void write(std::string const& equation, Scalar time, Index outerIteration, LinearSolveRecord const& record);
+
+private:
+
+    std::ofstream m_file;
+};
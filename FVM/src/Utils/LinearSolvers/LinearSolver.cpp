@@ -0,0 +1,160 @@
+#include "LinearSolver.h"
+#include "Utils/Timer.h"
+
+#include <algorithm>
+#include <cassert>
+
+
+LinearSolver::LinearSolver(LinearSolvers::Solver::Type solverType, std::unique_ptr<PreconditionerBase> preconditioner)
+    : m_solverType(solverType)
+    , m_solver(makeKrylovSolver(solverType))
+    , m_preconditioner(std::move(preconditioner))
+{}
+
+
+void LinearSolver::setRefreshThreshold(Scalar threshold)
+{
+    m_refreshThreshold = threshold;
+}
+
+
+void LinearSolver::setSparseFormat(LinearSolvers::SparseFormat::Type format)
+{
+    m_operator = SparseOperator(format);
+    m_operator.setSinglePrecision(m_mixedPrecision);
+}
+
+
+void LinearSolver::setMixedPrecision(bool enabled)
+{
+    assert(m_preconditioner);
+
+    m_mixedPrecision = enabled;
+    m_solver = makeKrylovSolver(m_solverType);
+    if (enabled)
+    {
+        m_solver = std::make_unique<MixedPrecisionSolver>(std::move(m_solver));
+    }
+
+    m_solver->setMaxIterations(m_maxIterations);
+
+    m_operator.setSinglePrecision(enabled);
+    m_preconditioner->setSinglePrecision(enabled);
+    // Forces preconditioner update, so it makes the float copy
+    m_diagonal.resize(0);
+}
+
+
+void LinearSolver::setMaxIterations(Index maxIterations)
+{
+    assert(m_solver);
+
+    m_maxIterations = maxIterations;
+    m_solver->setMaxIterations(maxIterations);
+}
+
+
+void LinearSolver::setInitialResidualTolerance(bool enabled)
+{
+    m_initialResidualTolerance = enabled;
+}
+
+
+Matrix LinearSolver::solve(SparseMatrix const& A, Matrix const& rhs, Scalar tolerance)
+{
+    bool fits = m_solution.rows() == rhs.rows() && m_solution.cols() == rhs.cols();
+    if (!fits)
+    {
+        m_solution = Matrix::Zero(rhs.rows(), rhs.cols());
+    }
+    return solve(A, rhs, m_solution, tolerance);
+}
+
+
+Matrix LinearSolver::solve(SparseMatrix const& A, Matrix const& rhs, Matrix const& guess, Scalar tolerance)
+{
+    assert(m_solver && m_preconditioner);
+    assert(A.cols() == A.rows());
+    assert(A.rows() == rhs.rows());
+    assert(A.rows() == guess.rows());
+    assert(rhs.cols() == guess.cols());
+
+    Timer setupTimer, solveTimer;
+
+    setupTimer.start();
+    updatePreconditioner(A);
+    m_operator.update(A);
+    setupTimer.stop();
+
+    solveTimer.start();
+    // guess may refer to m_solution
+    Matrix result = guess;
+
+    m_solver->setTolerance(m_initialResidualTolerance ? initialResidualRatio(rhs, result) * tolerance : tolerance);
+    m_record.converged = m_solver->solveBlock(m_operator, *m_preconditioner, rhs, result);
+    solveTimer.stop();
+
+    m_record.iterations = m_solver->iterations();
+    m_record.columns = rhs.cols();
+    m_record.error = m_solver->error();
+    m_record.setupTime = setupTimer.getElapsedTime();
+    m_record.solveTime = solveTimer.getElapsedTime();
+
+    m_solution = result;
+    return result;
+}
+
+
+LinearSolveRecord const& LinearSolver::getRecord() const
+{
+    return m_record;
+}
+
+
+Index LinearSolver::iterations() const
+{
+    return m_record.iterations;
+}
+
+
+bool LinearSolver::preconditionerUpdated() const
+{
+    return m_record.preconditionerUpdated;
+}
+
+
+Scalar LinearSolver::initialResidualRatio(Matrix const& rhs, Matrix const& guess) const
+{
+    Matrix product;
+    m_operator.multiply(guess, product);
+
+    // Columns share the tolerance, so the strictest one is taken
+    Scalar ratio = 1;
+    for (Index col = 0; col < rhs.cols(); col++)
+    {
+        Scalar rhsNorm = rhs.col(col).norm();
+        if (rhsNorm != 0)
+        {
+            ratio = std::min(ratio, (rhs.col(col) - product.col(col)).norm() / rhsNorm);
+        }
+    }
+    return ratio;
+}
+
+
+void LinearSolver::updatePreconditioner(SparseMatrix const& A)
+{
+    Field<Scalar> diagonal = A.diagonal();
+
+    m_record.preconditionerUpdated =
+    (
+        m_diagonal.rows() != diagonal.rows()
+        || (diagonal - m_diagonal).norm() >= m_refreshThreshold * m_diagonal.norm()
+    );
+
+    if (m_record.preconditionerUpdated)
+    {
+        m_preconditioner->compute(A);
+        m_diagonal = std::move(diagonal);
+    }
+}
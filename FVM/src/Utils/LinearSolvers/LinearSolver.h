@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Utils/Types.h"
+#include "LinearSolverTypes.h"
+#include "KrylovSolvers.h"
+#include "Preconditioners.h"
+#include "SparseOperator.h"
+#include "LinearSolveRecord.h"
+
+#include <memory>
+
+
+// Keeps Krylov solver, preconditioner and the last solution between solves.
+// Preconditioner is recomputed only when the matrix size changes or
+// its diagonal drifts from the one the preconditioner was built for
+class LinearSolver
+{
+public:
+
+    LinearSolver() = default;
+
+    LinearSolver(LinearSolvers::Solver::Type solverType, std::unique_ptr<PreconditionerBase> preconditioner);
+
+    // Relative change of the diagonal norm which triggers preconditioner update,
+    // zero updates it on every solve
+    void setRefreshThreshold(Scalar threshold);
+
+    // Layout of the matrix for products inside the Krylov solver
+    void setSparseFormat(LinearSolvers::SparseFormat::Type format);
+
+    // Krylov iterations in float inside double iterative refinement
+    void setMixedPrecision(bool enabled);
+
+    // Cap on iterations of each solve, non positive value means twice the matrix size
+    void setMaxIterations(Index maxIterations);
+
+    // Tolerance is relative to the residual of the guess instead of rhs,
+    // as inexact outer iterations need when the guess is warm
+    void setInitialResidualTolerance(bool enabled);
+
+    // Starts from the previous solution if it fits
+    Matrix solve(SparseMatrix const& A, Matrix const& rhs, Scalar tolerance);
+
+    Matrix solve(SparseMatrix const& A, Matrix const& rhs, Matrix const& guess, Scalar tolerance);
+
+    // Statistics of the last solve, iterations are the maximum over rhs columns
+    LinearSolveRecord const& getRecord() const;
+    Index iterations() const;
+    bool preconditionerUpdated() const;
+
+private:
+
+    LinearSolvers::Solver::Type m_solverType = LinearSolvers::Solver::BICGSTAB;
+    std::unique_ptr<KrylovSolverBase> m_solver;
+    std::unique_ptr<PreconditionerBase> m_preconditioner;
+    SparseOperator m_operator;
+
+    Scalar m_refreshThreshold = 0.1;
+    bool m_mixedPrecision = false;
+    Index m_maxIterations = 0;
+    bool m_initialResidualTolerance = false;
+    // Diagonal of the matrix the preconditioner was computed for
+    Field<Scalar> m_diagonal;
+    Matrix m_solution;
+
+    LinearSolveRecord m_record;
+
+    void updatePreconditioner(SparseMatrix const& A);
+    Scalar initialResidualRatio(Matrix const& rhs, Matrix const& guess) const;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+
+namespace LinearSolvers::Solver
+{
+
+enum Type
+{
+    // Only for symmetric matrices
+    CG,
+    BICGSTAB,
+    // Restarted GMRES
+    GMRES,
+    // Stationary iteration x += M^-1 (b - Ax), plain multigrid cycling with AMG,
+    // direct solve with LDLT and LU
+    RICHARDSON
+};
+
+}
+
+namespace LinearSolvers::Preconditioner
+{
+
+enum Type
+{
+    NONE,
+    JACOBI,
+    // Incomplete LU with the pattern of the matrix
+    ILU0,
+    // Incomplete Cholesky with the pattern of the matrix, only for symmetric matrices
+    IC0,
+    // Symmetric Gauss-Seidel
+    SGS,
+    // One V-cycle of smoothed aggregation algebraic multigrid
+    AMG,
+    // One cycle of geometric multigrid, only for cartesian meshes
+    GMG,
+    // Sparse direct factorizations, exact with Richardson solver.
+    // LDLT is only for symmetric matrices
+    LDLT,
+    LU
+};
+
+}
+
+namespace LinearSolvers::MultigridCycle
+{
+
+enum Type
+{
+    V,
+    W,
+    F
+};
+
+}
+
+namespace LinearSolvers::SparseFormat
+{
+
+enum Type
+{
+    // Compressed rows, as SparseMatrix itself
+    CSR,
+    // Sliced ELLPACK with rows sorted by length inside windows,
+    // chunks of rows are multiplied with SIMD
+    SELL
+};
+
+}
@@ -0,0 +1,26 @@
+#include "MultigridLevel.h"
+
+
+void MultigridLevel::computeInverseDiagonal()
+{
+    operators.inverseDiagonal = operators.A.diagonal();
+    for (Scalar& value : operators.inverseDiagonal)
+    {
+        value = (value != 0 ? 1 / value : 1);
+    }
+}
+
+
+void MultigridLevel::computeSingleOperators()
+{
+    singleOperators.A = operators.A.cast<float>();
+    singleOperators.inverseDiagonal = operators.inverseDiagonal.cast<float>();
+    singleOperators.P = operators.P.cast<float>();
+    singleOperators.R = operators.R.cast<float>();
+}
+
+
+void MultigridCoarsestSolver::compute(SparseMatrix const& A)
+{
+    m_lu.compute(Matrix(A));
+}
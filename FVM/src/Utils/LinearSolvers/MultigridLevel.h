@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Utils/Types.h"
+
+#include <Eigen/LU>
+#include <type_traits>
+
+
+// Operators of one multigrid level in one precision
+template<class T>
+struct MultigridOperators
+{
+    Eigen::SparseMatrix<T, Eigen::RowMajor> A;
+    Field<T> inverseDiagonal;
+    // Prolongation from the next level and restriction to it
+    Eigen::SparseMatrix<T, Eigen::RowMajor> P;
+    Eigen::SparseMatrix<T, Eigen::RowMajor> R;
+};
+
+
+// Level machinery shared by algebraic and geometric multigrid,
+// cycles are templated on precision and pick operators with operatorsOf
+struct MultigridLevel
+{
+    MultigridOperators<Scalar> operators;
+    // Rounded operators for mixed precision cycles, built in double
+    MultigridOperators<float> singleOperators;
+
+    // Zero diagonal entries are replaced by 1
+    void computeInverseDiagonal();
+    void computeSingleOperators();
+
+    template<class T>
+    MultigridOperators<T> const& operatorsOf() const
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+            return singleOperators;
+        }
+        else
+        {
+            return operators;
+        }
+    }
+};
+
+
+// Dense LU of the coarsest level
+class MultigridCoarsestSolver
+{
+public:
+
+    void compute(SparseMatrix const& A);
+
+    // Coarsest system is small, so float cycle solves it in double as well
+    template<class T>
+    void solve(Field<T> const& b, Field<T>& x) const
+    {
+        x = m_lu.solve(b.template cast<Scalar>()).template cast<T>();
+    }
+
+private:
+
+    Eigen::PartialPivLU<Matrix> m_lu;
+};
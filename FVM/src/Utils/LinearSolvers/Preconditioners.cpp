@@ -0,0 +1,553 @@
+#include "Preconditioners.h"
+#include "AlgebraicMultigrid.h"
+#include "DirectSolvers.h"
+
+#include <Eigen/LU>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+
+// Position of diagonal entry in the values array for each row,
+// matrix should be compressed with sorted columns
+static List<Index> findDiagonalPositions(SparseMatrix const& A)
+{
+    Index size = A.rows();
+    Index const* columns = A.innerIndexPtr();
+    Index const* rowStarts = A.outerIndexPtr();
+
+    List<Index> positions(size);
+    for (Index row = 0; row < size; row++)
+    {
+        Index const* rowBegin = columns + rowStarts[row];
+        Index const* rowEnd = columns + rowStarts[row+1];
+        Index const* diag = std::lower_bound(rowBegin, rowEnd, row);
+
+        if (diag == rowEnd || *diag != row)
+        {
+            throw std::runtime_error("Preconditioner requires non zero diagonal\n");
+        }
+        positions[row] = diag - columns;
+    }
+
+    return positions;
+}
+
+
+void PreconditionerBase::applySingle(Field<float> const& r, Field<float>& z) const
+{
+    Field<Scalar> zDouble;
+    apply(r.cast<Scalar>(), zDouble);
+    z = zDouble.cast<float>();
+}
+
+
+void PreconditionerBase::setSinglePrecision(bool enabled)
+{
+    m_singlePrecision = enabled;
+}
+
+
+void IdentityPreconditioner::compute(SparseMatrix const&) {}
+
+
+void IdentityPreconditioner::apply(Field<Scalar> const& r, Field<Scalar>& z) const
+{
+    z = r;
+}
+
+
+void JacobiPreconditioner::compute(SparseMatrix const& A)
+{
+    m_inverseDiagonal = A.diagonal();
+
+    for (Scalar& value : m_inverseDiagonal)
+    {
+        value = (value != 0 ? 1 / value : 1);
+    }
+
+    if (m_singlePrecision)
+    {
+        m_inverseDiagonalSingle = m_inverseDiagonal.cast<float>();
+    }
+}
+
+
+void JacobiPreconditioner::apply(Field<Scalar> const& r, Field<Scalar>& z) const
+{
+    z = m_inverseDiagonal.cwiseProduct(r);
+}
+
+
+void JacobiPreconditioner::applySingle(Field<float> const& r, Field<float>& z) const
+{
+    z = m_inverseDiagonalSingle.cwiseProduct(r);
+}
+
+
+void ILU0Preconditioner::compute(SparseMatrix const& A)
+{
+    assert(A.rows() == A.cols());
+
+    m_factors = A;
+    m_factors.makeCompressed();
+    m_diagonalPositions = findDiagonalPositions(m_factors);
+
+    Index size = m_factors.rows();
+    Scalar* values = m_factors.valuePtr();
+    Index const* columns = m_factors.innerIndexPtr();
+    Index const* rowStarts = m_factors.outerIndexPtr();
+
+    // Position of column in the current row or -1
+    List<Index> positionInRow(size, -1);
+
+    for (Index row = 0; row < size; row++)
+    {
+        for (Index pos = rowStarts[row]; pos < rowStarts[row+1]; pos++)
+        {
+            positionInRow[columns[pos]] = pos;
+        }
+
+        for (Index pos = rowStarts[row]; pos < m_diagonalPositions[row]; pos++)
+        {
+            Index k = columns[pos];
+            values[pos] /= values[m_diagonalPositions[k]];
+
+            // Updating only entries inside the pattern of row
+            for (Index kPos = m_diagonalPositions[k] + 1; kPos < rowStarts[k+1]; kPos++)
+            {
+                Index rowPos = positionInRow[columns[kPos]];
+                if (rowPos != -1)
+                {
+                    values[rowPos] -= values[pos] * values[kPos];
+                }
+            }
+        }
+
+        for (Index pos = rowStarts[row]; pos < rowStarts[row+1]; pos++)
+        {
+            positionInRow[columns[pos]] = -1;
+        }
+    }
+
+    // Factorization itself stays in double, only the result is rounded
+    if (m_singlePrecision)
+    {
+        m_factorsSingle = m_factors.cast<float>();
+    }
+}
+
+
+// Forward and backward substitution with factors stored in place
+template<class T>
+static void solveFactors
+(
+    Eigen::SparseMatrix<T, Eigen::RowMajor> const& factors,
+    List<Index> const& diagonalPositions,
+    Field<T> const& r,
+    Field<T>& z
+)
+{
+    Index size = factors.rows();
+    T const* values = factors.valuePtr();
+    Index const* columns = factors.innerIndexPtr();
+    Index const* rowStarts = factors.outerIndexPtr();
+
+    z.resize(size);
+
+    // L y = r
+    for (Index row = 0; row < size; row++)
+    {
+        T sum = r(row);
+        for (Index pos = rowStarts[row]; pos < diagonalPositions[row]; pos++)
+        {
+            sum -= values[pos] * z(columns[pos]);
+        }
+        z(row) = sum;
+    }
+
+    // U z = y
+    for (Index row = size - 1; row >= 0; row--)
+    {
+        T sum = z(row);
+        for (Index pos = diagonalPositions[row] + 1; pos < rowStarts[row+1]; pos++)
+        {
+            sum -= values[pos] * z(columns[pos]);
+        }
+        z(row) = sum / values[diagonalPositions[row]];
+    }
+}
+
+
+void ILU0Preconditioner::apply(Field<Scalar> const& r, Field<Scalar>& z) const
+{
+    solveFactors(m_factors, m_diagonalPositions, r, z);
+}
+
+
+void ILU0Preconditioner::applySingle(Field<float> const& r, Field<float>& z) const
+{
+    solveFactors(m_factorsSingle, m_diagonalPositions, r, z);
+}
+
+
+BlockILU0Preconditioner::BlockILU0Preconditioner(Index blockSize)
+    : m_blockSize(blockSize)
+{
+    assert(blockSize > 0);
+}
+
+
+void BlockILU0Preconditioner::compute(SparseMatrix const& A)
+{
+    assert(A.rows() == A.cols() && A.rows() % m_blockSize == 0);
+
+    Index blockRows = A.rows() / m_blockSize;
+    Index blockArea = m_blockSize * m_blockSize;
+
+    // Block pattern, diagonal block is always present
+    m_rowStarts.assign(blockRows + 1, 0);
+    m_columns.clear();
+    for (Index blockRow = 0; blockRow < blockRows; blockRow++)
+    {
+        Index rowStart = m_columns.size();
+        m_columns.push_back(blockRow);
+        for (Index row = blockRow * m_blockSize; row < (blockRow + 1) * m_blockSize; row++)
+        {
+            for (SparseMatrix::InnerIterator iter(A, row); iter; ++iter)
+            {
+                m_columns.push_back(iter.col() / m_blockSize);
+            }
+        }
+        std::sort(m_columns.begin() + rowStart, m_columns.end());
+        m_columns.erase(std::unique(m_columns.begin() + rowStart, m_columns.end()), m_columns.end());
+        m_rowStarts[blockRow + 1] = m_columns.size();
+    }
+
+    m_values.assign(m_columns.size() * blockArea, 0);
+    m_diagonalPositions.resize(blockRows);
+    for (Index blockRow = 0; blockRow < blockRows; blockRow++)
+    {
+        auto rowBegin = m_columns.begin() + m_rowStarts[blockRow];
+        auto rowEnd = m_columns.begin() + m_rowStarts[blockRow + 1];
+        m_diagonalPositions[blockRow] = std::lower_bound(rowBegin, rowEnd, blockRow) - m_columns.begin();
+
+        for (Index row = blockRow * m_blockSize; row < (blockRow + 1) * m_blockSize; row++)
+        {
+            for (SparseMatrix::InnerIterator iter(A, row); iter; ++iter)
+            {
+                Index pos = std::lower_bound(rowBegin, rowEnd, iter.col() / m_blockSize) - m_columns.begin();
+                block(pos)(row % m_blockSize, iter.col() % m_blockSize) = iter.value();
+            }
+        }
+    }
+
+    // Same elimination as scalar ILU0 with blocks in place of values
+    List<Index> positionInRow(blockRows, -1);
+    Matrix lower;
+    for (Index blockRow = 0; blockRow < blockRows; blockRow++)
+    {
+        for (Index pos = m_rowStarts[blockRow]; pos < m_rowStarts[blockRow + 1]; pos++)
+        {
+            positionInRow[m_columns[pos]] = pos;
+        }
+
+        for (Index pos = m_rowStarts[blockRow]; pos < m_diagonalPositions[blockRow]; pos++)
+        {
+            Index k = m_columns[pos];
+            lower = block(pos) * block(m_diagonalPositions[k]);
+            block(pos) = lower;
+
+            for (Index kPos = m_diagonalPositions[k] + 1; kPos < m_rowStarts[k+1]; kPos++)
+            {
+                Index rowPos = positionInRow[m_columns[kPos]];
+                if (rowPos != -1)
+                {
+                    block(rowPos).noalias() -= lower * block(kPos);
+                }
+            }
+        }
+
+        for (Index pos = m_rowStarts[blockRow]; pos < m_rowStarts[blockRow + 1]; pos++)
+        {
+            positionInRow[m_columns[pos]] = -1;
+        }
+
+        Matrix inverse = block(m_diagonalPositions[blockRow]).partialPivLu().inverse();
+        if (!inverse.allFinite())
+        {
+            throw std::runtime_error("Preconditioner requires non singular diagonal blocks\n");
+        }
+        block(m_diagonalPositions[blockRow]) = inverse;
+    }
+}
+
+
+void BlockILU0Preconditioner::apply(Field<Scalar> const& r, Field<Scalar>& z) const
+{
+    Index blockRows = m_diagonalPositions.size();
+    z.resize(r.rows());
+    Field<Scalar> sum(m_blockSize);
+
+    // L y = r, L has identity diagonal blocks
+    for (Index blockRow = 0; blockRow < blockRows; blockRow++)
+    {
+        sum = r.segment(blockRow * m_blockSize, m_blockSize);
+        for (Index pos = m_rowStarts[blockRow]; pos < m_diagonalPositions[blockRow]; pos++)
+        {
+            sum.noalias() -= block(pos) * z.segment(m_columns[pos] * m_blockSize, m_blockSize);
+        }
+        z.segment(blockRow * m_blockSize, m_blockSize) = sum;
+    }
+
+    // U z = y
+    for (Index blockRow = blockRows - 1; blockRow >= 0; blockRow--)
+    {
+        sum = z.segment(blockRow * m_blockSize, m_blockSize);
+        for (Index pos = m_diagonalPositions[blockRow] + 1; pos < m_rowStarts[blockRow + 1]; pos++)
+        {
+            sum.noalias() -= block(pos) * z.segment(m_columns[pos] * m_blockSize, m_blockSize);
+        }
+        z.segment(blockRow * m_blockSize, m_blockSize).noalias() = block(m_diagonalPositions[blockRow]) * sum;
+    }
+}
+
+
+Eigen::Map<Matrix> BlockILU0Preconditioner::block(Index pos)
+{
+    return Eigen::Map<Matrix>(m_values.data() + pos * m_blockSize * m_blockSize, m_blockSize, m_blockSize);
+}
+
+
+Eigen::Map<Matrix const> BlockILU0Preconditioner::block(Index pos) const
+{
+    return Eigen::Map<Matrix const>(m_values.data() + pos * m_blockSize * m_blockSize, m_blockSize, m_blockSize);
+}
+
+
+void IC0Preconditioner::compute(SparseMatrix const& A)
+{
+    assert(A.rows() == A.cols());
+
+    m_lower = A.triangularView<Eigen::Lower>();
+    m_lower.makeCompressed();
+
+    // Diagonal of the last row is always the last entry of the row
+    Index size = m_lower.rows();
+    Scalar* values = m_lower.valuePtr();
+    Index const* columns = m_lower.innerIndexPtr();
+    Index const* rowStarts = m_lower.outerIndexPtr();
+
+    for (Index row = 0; row < size; row++)
+    {
+        if (rowStarts[row] == rowStarts[row+1] || columns[rowStarts[row+1]-1] != row)
+        {
+            throw std::runtime_error("Preconditioner requires non zero diagonal\n");
+        }
+    }
+
+    m_sign = (size > 0 && values[rowStarts[1]-1] < 0 ? -1 : 1);
+    m_lower *= m_sign;
+
+    List<Index> positionInRow(size, -1);
+
+    for (Index row = 0; row < size; row++)
+    {
+        Index diagPos = rowStarts[row+1] - 1;
+        Scalar originalDiagonal = values[diagPos];
+
+        for (Index pos = rowStarts[row]; pos < diagPos; pos++)
+        {
+            Index k = columns[pos];
+
+            // L_ik = (a_ik - sum_j<k L_ij L_kj) / L_kk
+            Scalar sum = values[pos];
+            for (Index kPos = rowStarts[k]; kPos < rowStarts[k+1] - 1; kPos++)
+            {
+                Index rowPos = positionInRow[columns[kPos]];
+                if (rowPos != -1)
+                {
+                    sum -= values[rowPos] * values[kPos];
+                }
+            }
+            values[pos] = sum / values[rowStarts[k+1] - 1];
+            positionInRow[k] = pos;
+        }
+
+        Scalar diagonal = originalDiagonal;
+        for (Index pos = rowStarts[row]; pos < diagPos; pos++)
+        {
+            diagonal -= values[pos] * values[pos];
+            positionInRow[columns[pos]] = -1;
+        }
+
+        // Breakdown on a not positive pivot, keeping original diagonal instead
+        if (diagonal <= 0)
+        {
+            diagonal = std::abs(originalDiagonal);
+        }
+        values[diagPos] = std::sqrt(diagonal);
+    }
+
+    if (m_singlePrecision)
+    {
+        m_lowerSingle = m_lower.cast<float>();
+    }
+}
+
+
+// Substitutions with L and L^T, columns of L^T are rows of L
+template<class T>
+static void solveCholeskyFactors(Eigen::SparseMatrix<T, Eigen::RowMajor> const& lower, T sign, Field<T> const& r, Field<T>& z)
+{
+    Index size = lower.rows();
+    T const* values = lower.valuePtr();
+    Index const* columns = lower.innerIndexPtr();
+    Index const* rowStarts = lower.outerIndexPtr();
+
+    z.resize(size);
+
+    // L y = r
+    for (Index row = 0; row < size; row++)
+    {
+        Index diagPos = rowStarts[row+1] - 1;
+        T sum = r(row);
+        for (Index pos = rowStarts[row]; pos < diagPos; pos++)
+        {
+            sum -= values[pos] * z(columns[pos]);
+        }
+        z(row) = sum / values[diagPos];
+    }
+
+    // L^T z = y
+    for (Index row = size - 1; row >= 0; row--)
+    {
+        Index diagPos = rowStarts[row+1] - 1;
+        z(row) /= values[diagPos];
+        for (Index pos = rowStarts[row]; pos < diagPos; pos++)
+        {
+            z(columns[pos]) -= values[pos] * z(row);
+        }
+    }
+
+    z *= sign;
+}
+
+
+void IC0Preconditioner::apply(Field<Scalar> const& r, Field<Scalar>& z) const
+{
+    solveCholeskyFactors(m_lower, m_sign, r, z);
+}
+
+
+void IC0Preconditioner::applySingle(Field<float> const& r, Field<float>& z) const
+{
+    solveCholeskyFactors(m_lowerSingle, float(m_sign), r, z);
+}
+
+
+void SGSPreconditioner::compute(SparseMatrix const& A)
+{
+    assert(A.rows() == A.cols());
+
+    m_matrix = A;
+    m_matrix.makeCompressed();
+    m_diagonalPositions = findDiagonalPositions(m_matrix);
+
+    if (m_singlePrecision)
+    {
+        m_matrixSingle = m_matrix.cast<float>();
+    }
+}
+
+
+template<class T>
+static void symmetricGaussSeidel
+(
+    Eigen::SparseMatrix<T, Eigen::RowMajor> const& A,
+    List<Index> const& diagonalPositions,
+    Field<T> const& r,
+    Field<T>& z
+)
+{
+    Index size = A.rows();
+    T const* values = A.valuePtr();
+    Index const* columns = A.innerIndexPtr();
+    Index const* rowStarts = A.outerIndexPtr();
+
+    z.resize(size);
+
+    // (D + L) y = r
+    for (Index row = 0; row < size; row++)
+    {
+        T sum = r(row);
+        for (Index pos = rowStarts[row]; pos < diagonalPositions[row]; pos++)
+        {
+            sum -= values[pos] * z(columns[pos]);
+        }
+        z(row) = sum / values[diagonalPositions[row]];
+    }
+
+    // (D + U) z = D y
+    for (Index row = size - 1; row >= 0; row--)
+    {
+        T sum = 0;
+        for (Index pos = diagonalPositions[row] + 1; pos < rowStarts[row+1]; pos++)
+        {
+            sum -= values[pos] * z(columns[pos]);
+        }
+        z(row) += sum / values[diagonalPositions[row]];
+    }
+}
+
+
+void SGSPreconditioner::apply(Field<Scalar> const& r, Field<Scalar>& z) const
+{
+    symmetricGaussSeidel(m_matrix, m_diagonalPositions, r, z);
+}
+
+
+void SGSPreconditioner::applySingle(Field<float> const& r, Field<float>& z) const
+{
+    symmetricGaussSeidel(m_matrixSingle, m_diagonalPositions, r, z);
+}
+
+
+std::unique_ptr<PreconditionerBase> makePreconditioner(LinearSolvers::Preconditioner::Type type)
+{
+    using namespace LinearSolvers::Preconditioner;
+
+    switch (type)
+    {
+    case NONE:
+        return std::make_unique<IdentityPreconditioner>();
+
+    case JACOBI:
+        return std::make_unique<JacobiPreconditioner>();
+
+    case ILU0:
+        return std::make_unique<ILU0Preconditioner>();
+
+    case IC0:
+        return std::make_unique<IC0Preconditioner>();
+
+    case SGS:
+        return std::make_unique<SGSPreconditioner>();
+
+    case AMG:
+        return std::make_unique<AMGPreconditioner>();
+
+    case GMG:
+        throw std::invalid_argument("Geometric multigrid needs grid sizes, construct it directly\n");
+
+    case LDLT:
+        return std::make_unique<LDLTPreconditioner>();
+
+    case LU:
+        return std::make_unique<SparseLUPreconditioner>();
+    }
+
+    throw std::invalid_argument("Unknown preconditioner type\n");
+}
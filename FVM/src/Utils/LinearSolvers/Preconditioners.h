@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Utils/Types.h"
+#include "LinearSolverTypes.h"
+
+#include <memory>
+
+
+class PreconditionerBase
+{
+public:
+
+    virtual ~PreconditionerBase() = default;
+
+    // Setup for the given matrix, matrix is not referenced after the call
+    virtual void compute(SparseMatrix const& A) = 0;
+
+    // Approximately solves M z = r
+    virtual void apply(Field<Scalar> const& r, Field<Scalar>& z) const = 0;
+
+    // Same for mixed precision solves. By default goes through double apply,
+    // preconditioners keeping single precision setup override it
+    virtual void applySingle(Field<float> const& r, Field<float>& z) const;
+
+    // Asks compute to keep single precision copy of the setup
+    void setSinglePrecision(bool enabled);
+
+protected:
+
+    bool m_singlePrecision = false;
+};
+
+
+class IdentityPreconditioner : public PreconditionerBase
+{
+public:
+
+    void compute(SparseMatrix const& A) override;
+    void apply(Field<Scalar> const& r, Field<Scalar>& z) const override;
+};
+
+
+class JacobiPreconditioner : public PreconditionerBase
+{
+public:
+
+    void compute(SparseMatrix const& A) override;
+    void apply(Field<Scalar> const& r, Field<Scalar>& z) const override;
+    void applySingle(Field<float> const& r, Field<float>& z) const override;
+
+private:
+
+    Field<Scalar> m_inverseDiagonal;
+    Field<float> m_inverseDiagonalSingle;
+};
+
+
+// Factors are stored in place of the matrix values,
+// L has unit diagonal and is stored below the diagonal
+class ILU0Preconditioner : public PreconditionerBase
+{
+public:
+
+    void compute(SparseMatrix const& A) override;
+    void apply(Field<Scalar> const& r, Field<Scalar>& z) const override;
+    void applySingle(Field<float> const& r, Field<float>& z) const override;
+
+private:
+
+    SparseMatrix m_factors;
+    Eigen::SparseMatrix<float, Eigen::RowMajor> m_factorsSingle;
+    List<Index> m_diagonalPositions;
+};
+
+
+// ILU0 of the matrix split into dense blockSize x blockSize blocks,
+// for systems with several unknowns per cell stored one after another.
+// Block pattern is the union of the scalar ones, diagonal blocks are kept inverted
+class BlockILU0Preconditioner : public PreconditionerBase
+{
+public:
+
+    explicit BlockILU0Preconditioner(Index blockSize);
+
+    void compute(SparseMatrix const& A) override;
+    void apply(Field<Scalar> const& r, Field<Scalar>& z) const override;
+
+private:
+
+    Index m_blockSize;
+
+    // Compressed block rows, each block is stored column major
+    List<Index> m_rowStarts;
+    List<Index> m_columns;
+    List<Index> m_diagonalPositions;
+    List<Scalar> m_values;
+
+    Eigen::Map<Matrix> block(Index pos);
+    Eigen::Map<Matrix const> block(Index pos) const;
+};
+
+
+// Only lower triangle of the matrix is used.
+// Pressure correction matrix is negative definite, so for negative diagonal
+// -A is factored and the sign is restored in apply
+class IC0Preconditioner : public PreconditionerBase
+{
+public:
+
+    void compute(SparseMatrix const& A) override;
+    void apply(Field<Scalar> const& r, Field<Scalar>& z) const override;
+    void applySingle(Field<float> const& r, Field<float>& z) const override;
+
+private:
+
+    // Lower triangle with the diagonal, M = m_sign * L L^T
+    SparseMatrix m_lower;
+    Eigen::SparseMatrix<float, Eigen::RowMajor> m_lowerSingle;
+    Scalar m_sign = 1;
+};
+
+
+// M = (D + L) D^-1 (D + U)
+class SGSPreconditioner : public PreconditionerBase
+{
+public:
+
+    void compute(SparseMatrix const& A) override;
+    void apply(Field<Scalar> const& r, Field<Scalar>& z) const override;
+    void applySingle(Field<float> const& r, Field<float>& z) const override;
+
+private:
+
+    SparseMatrix m_matrix;
+    Eigen::SparseMatrix<float, Eigen::RowMajor> m_matrixSingle;
+    List<Index> m_diagonalPositions;
+};
+
+
+std::unique_ptr<PreconditionerBase> makePreconditioner(LinearSolvers::Preconditioner::Type type);
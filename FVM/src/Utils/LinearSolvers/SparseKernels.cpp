@@ -0,0 +1,86 @@
+#include "SparseKernels.h"
+
+#include <cassert>
+
+
+template<Index columnAmount, class T>
+static void multiplyFixedColumns(Eigen::SparseMatrix<T, Eigen::RowMajor> const& A, T const* x, T* ax)
+{
+    T const* values = A.valuePtr();
+    Index const* columns = A.innerIndexPtr();
+    Index const* rowStarts = A.outerIndexPtr();
+    Index const* rowSizes = A.innerNonZeroPtr();
+
+    Index xSize = A.cols();
+    Index axSize = A.rows();
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index row = 0; row < A.rows(); row++)
+    {
+        Array<T, columnAmount> sum{};
+        Index end = rowSizes ? rowStarts[row] + rowSizes[row] : rowStarts[row+1];
+        for (Index pos = rowStarts[row]; pos < end; pos++)
+        {
+            T value = values[pos];
+            Index col = columns[pos];
+            for (Index k = 0; k < columnAmount; k++)
+            {
+                sum[k] += value * x[k*xSize + col];
+            }
+        }
+        for (Index k = 0; k < columnAmount; k++)
+        {
+            ax[k*axSize + row] = sum[k];
+        }
+    }
+}
+
+
+void multiplyColumns(SparseMatrix const& A, Matrix const& X, Matrix& AX)
+{
+    assert(A.cols() == X.rows());
+    assert(&X != &AX);
+
+    AX.resize(A.rows(), X.cols());
+
+    switch (X.cols())
+    {
+    case 1:
+        multiplyFixedColumns<1>(A, X.data(), AX.data());
+        break;
+
+    case 2:
+        multiplyFixedColumns<2>(A, X.data(), AX.data());
+        break;
+
+    case 3:
+        multiplyFixedColumns<3>(A, X.data(), AX.data());
+        break;
+
+    default:
+        AX.noalias() = A * X;
+        break;
+    }
+}
+
+
+void multiply(SparseMatrix const& A, Field<Scalar> const& x, Field<Scalar>& Ax)
+{
+    assert(A.cols() == x.rows());
+    assert(&x != &Ax);
+
+    Ax.resize(A.rows());
+    multiplyFixedColumns<1>(A, x.data(), Ax.data());
+}
+
+
+void multiply(SingleSparseMatrix const& A, Field<float> const& x, Field<float>& Ax)
+{
+    assert(A.cols() == x.rows());
+    assert(&x != &Ax);
+
+    Ax.resize(A.rows());
+    multiplyFixedColumns<1>(A, x.data(), Ax.data());
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Utils/Types.h"
+
+
+using SingleSparseMatrix = Eigen::SparseMatrix<float, Eigen::RowMajor>;
+
+
+// AX = A * X for all columns of X in one pass over A.
+// Eigen multiplies column by column and reads the matrix once per column,
+// while SpMV is memory bound, so with 2-3 columns the fused pass is much cheaper
+void multiplyColumns(SparseMatrix const& A, Matrix const& X, Matrix& AX);
+
+// Ax = A * x, parallel over rows
+void multiply(SparseMatrix const& A, Field<Scalar> const& x, Field<Scalar>& Ax);
+
+void multiply(SingleSparseMatrix const& A, Field<float> const& x, Field<float>& Ax);
@@ -0,0 +1,359 @@
+#include "SparseOperator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <stdexcept>
+
+
+// Range of row values, matrix may be uncompressed
+static std::pair<Index, Index> rowRange(SparseMatrix const& A, Index row)
+{
+    Index begin = A.outerIndexPtr()[row];
+    Index end = A.innerNonZeroPtr() ? begin + A.innerNonZeroPtr()[row] : A.outerIndexPtr()[row+1];
+    return {begin, end};
+}
+
+
+SparseOperator::SparseOperator(LinearSolvers::SparseFormat::Type format)
+    : m_format(format)
+{}
+
+
+SparseOperator::SparseOperator(SparseMatrix const& A)
+    : SparseOperator(A, LinearSolvers::SparseFormat::CSR)
+{}
+
+
+SparseOperator::SparseOperator(SparseMatrix const& A, LinearSolvers::SparseFormat::Type format)
+    : m_format(format)
+{
+    update(A);
+}
+
+
+void SparseOperator::update(SparseMatrix const& A)
+{
+    m_rows = A.rows();
+    m_cols = A.cols();
+
+    if (m_format == LinearSolvers::SparseFormat::CSR)
+    {
+        m_matrix = &A;
+        if (m_singlePrecision)
+        {
+            updateSingleMatrix(A);
+        }
+        return;
+    }
+
+    if (!patternMatches(A))
+    {
+        buildLayout(A);
+    }
+
+    // Padding stays zero
+    if (m_singlePrecision && m_singleValues.size() != m_values.size())
+    {
+        m_singleValues.assign(m_values.size(), 0);
+    }
+
+    Scalar const* values = A.valuePtr();
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index row = 0; row < m_rows; row++)
+    {
+        auto [begin, end] = rowRange(A, row);
+        for (Index pos = begin; pos < end; pos++)
+        {
+            m_values[m_rowOffsets[row] + (pos - begin) * chunkSize] = values[pos];
+        }
+    }
+
+    if (m_singlePrecision)
+    {
+        std::copy(m_values.begin(), m_values.end(), m_singleValues.begin());
+    }
+}
+
+
+void SparseOperator::updateSingleMatrix(SparseMatrix const& A)
+{
+    bool samePattern =
+    (
+        A.isCompressed()
+        && m_singleMatrix.rows() == A.rows()
+        && m_singleMatrix.cols() == A.cols()
+        && m_singleMatrix.nonZeros() == A.nonZeros()
+        && std::equal(A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1, m_singleMatrix.outerIndexPtr())
+        && std::equal(A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros(), m_singleMatrix.innerIndexPtr())
+    );
+
+    if (!samePattern)
+    {
+        m_singleMatrix = A.cast<float>();
+        m_singleMatrix.makeCompressed();
+        return;
+    }
+
+    Scalar const* values = A.valuePtr();
+    float* singleValues = m_singleMatrix.valuePtr();
+    Index size = A.nonZeros();
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index pos = 0; pos < size; pos++)
+    {
+        singleValues[pos] = values[pos];
+    }
+}
+
+
+void SparseOperator::setSinglePrecision(bool enabled)
+{
+    m_singlePrecision = enabled;
+    if (!enabled)
+    {
+        m_singleMatrix = SingleSparseMatrix();
+        m_singleValues.clear();
+    }
+}
+
+
+bool SparseOperator::patternMatches(SparseMatrix const& A) const
+{
+    if (Index(m_patternRowStarts.size()) != A.rows() + 1)
+    {
+        return false;
+    }
+
+    Index const* columns = A.innerIndexPtr();
+    for (Index row = 0; row < A.rows(); row++)
+    {
+        auto [begin, end] = rowRange(A, row);
+        Index patternBegin = m_patternRowStarts[row];
+        if (end - begin != m_patternRowStarts[row+1] - patternBegin)
+        {
+            return false;
+        }
+        if (!std::equal(columns + begin, columns + end, m_patternColumns.begin() + patternBegin))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void SparseOperator::buildLayout(SparseMatrix const& A)
+{
+    Index const* columns = A.innerIndexPtr();
+
+    m_patternRowStarts.assign(1, 0);
+    m_patternColumns.clear();
+    for (Index row = 0; row < m_rows; row++)
+    {
+        auto [begin, end] = rowRange(A, row);
+        m_patternColumns.insert(m_patternColumns.end(), columns + begin, columns + end);
+        m_patternRowStarts.push_back(m_patternColumns.size());
+    }
+
+    auto rowLength = [this](Index row)
+    {
+        return m_patternRowStarts[row+1] - m_patternRowStarts[row];
+    };
+
+    // Sorting only inside windows keeps rows close to their neighbours in x
+    List<Index> order(m_rows);
+    std::iota(order.begin(), order.end(), 0);
+    for (Index windowBegin = 0; windowBegin < m_rows; windowBegin += sortingWindow)
+    {
+        Index windowEnd = std::min(windowBegin + sortingWindow, m_rows);
+        std::stable_sort
+        (
+            order.begin() + windowBegin, order.begin() + windowEnd,
+            [&rowLength](Index lhs, Index rhs) { return rowLength(lhs) > rowLength(rhs); }
+        );
+    }
+
+    Index chunkAmount = (m_rows + chunkSize - 1) / chunkSize;
+    m_chunkStarts.assign(chunkAmount + 1, 0);
+    m_laneRows.assign(chunkAmount * chunkSize, -1);
+    m_rowOffsets.resize(m_rows);
+
+    for (Index chunk = 0; chunk < chunkAmount; chunk++)
+    {
+        Index width = 0;
+        for (Index lane = 0; lane < chunkSize && chunk*chunkSize + lane < m_rows; lane++)
+        {
+            Index row = order[chunk*chunkSize + lane];
+            m_laneRows[chunk*chunkSize + lane] = row;
+            m_rowOffsets[row] = m_chunkStarts[chunk] + lane;
+            width = std::max(width, rowLength(row));
+        }
+        m_chunkStarts[chunk+1] = m_chunkStarts[chunk] + width * chunkSize;
+    }
+
+    // Padding multiplies zero by x of the lane own row, which is always valid
+    m_values.assign(m_chunkStarts.back(), 0);
+    m_singleValues.clear();
+    m_columns.resize(m_chunkStarts.back());
+    for (Index chunk = 0; chunk < chunkAmount; chunk++)
+    {
+        Index width = (m_chunkStarts[chunk+1] - m_chunkStarts[chunk]) / chunkSize;
+        for (Index lane = 0; lane < chunkSize; lane++)
+        {
+            Index row = m_laneRows[chunk*chunkSize + lane];
+            Index padColumn = std::clamp(row, 0, m_cols - 1);
+            for (Index j = 0; j < width; j++)
+            {
+                Index slot = m_chunkStarts[chunk] + j*chunkSize + lane;
+                bool isValue = row >= 0 && j < rowLength(row);
+                m_columns[slot] = isValue ? m_patternColumns[m_patternRowStarts[row] + j] : padColumn;
+            }
+        }
+    }
+}
+
+
+Index SparseOperator::rows() const
+{
+    return m_rows;
+}
+
+
+Index SparseOperator::cols() const
+{
+    return m_cols;
+}
+
+
+LinearSolvers::SparseFormat::Type SparseOperator::format() const
+{
+    return m_format;
+}
+
+
+template<class T, Index columnAmount>
+void SparseOperator::multiplyChunks(T const* chunkValues, T const* x, T* ax) const
+{
+    Index chunkAmount = m_chunkStarts.size() - 1;
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index chunk = 0; chunk < chunkAmount; chunk++)
+    {
+        T sum[columnAmount][chunkSize] = {};
+
+        for (Index slot = m_chunkStarts[chunk]; slot < m_chunkStarts[chunk+1]; slot += chunkSize)
+        {
+            T const* values = chunkValues + slot;
+            Index const* columns = m_columns.data() + slot;
+            for (Index k = 0; k < columnAmount; k++)
+            {
+#ifdef _OPENMP
+                #pragma omp simd
+#endif
+                for (Index lane = 0; lane < chunkSize; lane++)
+                {
+                    sum[k][lane] += values[lane] * x[k*m_cols + columns[lane]];
+                }
+            }
+        }
+
+        for (Index lane = 0; lane < chunkSize; lane++)
+        {
+            Index row = m_laneRows[chunk*chunkSize + lane];
+            if (row < 0)
+            {
+                continue;
+            }
+            for (Index k = 0; k < columnAmount; k++)
+            {
+                ax[k*m_rows + row] = sum[k][lane];
+            }
+        }
+    }
+}
+
+
+void SparseOperator::multiply(Field<Scalar> const& x, Field<Scalar>& Ax) const
+{
+    assert(x.rows() == m_cols);
+
+    if (m_format == LinearSolvers::SparseFormat::CSR)
+    {
+        ::multiply(*m_matrix, x, Ax);
+        return;
+    }
+
+    Ax.resize(m_rows);
+    multiplyChunks<Scalar, 1>(m_values.data(), x.data(), Ax.data());
+}
+
+
+void SparseOperator::multiply(Matrix const& X, Matrix& AX) const
+{
+    assert(X.rows() == m_cols);
+
+    if (m_format == LinearSolvers::SparseFormat::CSR)
+    {
+        multiplyColumns(*m_matrix, X, AX);
+        return;
+    }
+
+    AX.resize(m_rows, X.cols());
+    switch (X.cols())
+    {
+    case 1:
+        multiplyChunks<Scalar, 1>(m_values.data(), X.data(), AX.data());
+        break;
+
+    case 2:
+        multiplyChunks<Scalar, 2>(m_values.data(), X.data(), AX.data());
+        break;
+
+    case 3:
+        multiplyChunks<Scalar, 3>(m_values.data(), X.data(), AX.data());
+        break;
+
+    default:
+        for (Index col = 0; col < X.cols(); col++)
+        {
+            multiplyChunks<Scalar, 1>(m_values.data(), X.col(col).data(), AX.col(col).data());
+        }
+        break;
+    }
+}
+
+
+Field<Scalar> SparseOperator::operator*(Field<Scalar> const& x) const
+{
+    Field<Scalar> Ax;
+    multiply(x, Ax);
+    return Ax;
+}
+
+
+void SparseOperator::multiply(Field<float> const& x, Field<float>& Ax) const
+{
+    assert(x.rows() == m_cols);
+
+    if (!m_singlePrecision)
+    {
+        throw std::logic_error("Single precision copy of the matrix is disabled\n");
+    }
+
+    if (m_format == LinearSolvers::SparseFormat::CSR)
+    {
+        ::multiply(m_singleMatrix, x, Ax);
+        return;
+    }
+
+    Ax.resize(m_rows);
+    multiplyChunks<float, 1>(m_singleValues.data(), x.data(), Ax.data());
+}
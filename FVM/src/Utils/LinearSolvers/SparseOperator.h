@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Utils/Types.h"
+#include "LinearSolverTypes.h"
+#include "SparseKernels.h"
+
+
+// Matrix-vector products for Krylov solvers.
+// CSR format only refers to the matrix, so it should outlive the operator.
+// SELL-C-sigma keeps its own copy: rows are sorted by length inside windows of
+// sortingWindow rows and split into chunks of chunkSize rows, each chunk is stored
+// column by column and padded to its longest row, so the lanes of a chunk
+// are processed together with SIMD
+class SparseOperator
+{
+public:
+
+    SparseOperator() = default;
+
+    // Empty until update
+    explicit SparseOperator(LinearSolvers::SparseFormat::Type format);
+
+    // CSR view refers to A, so it is explicit to keep temporaries from binding
+    explicit SparseOperator(SparseMatrix const& A);
+
+    explicit SparseOperator(SparseMatrix const& A, LinearSolvers::SparseFormat::Type format);
+
+    // Takes values of A, SELL layout is rebuilt only when the pattern changes
+    void update(SparseMatrix const& A);
+
+    // Keeps float values of the matrix on update for mixed precision solves,
+    // as CSR copy or next to SELL values. Both are refreshed in place while the pattern stays
+    void setSinglePrecision(bool enabled);
+
+    Index rows() const;
+    Index cols() const;
+    LinearSolvers::SparseFormat::Type format() const;
+
+    // Ax = A * x, parallel over rows
+    void multiply(Field<Scalar> const& x, Field<Scalar>& Ax) const;
+
+    // All columns in one pass over the matrix
+    void multiply(Matrix const& X, Matrix& AX) const;
+
+    Field<Scalar> operator*(Field<Scalar> const& x) const;
+
+    // Requires single precision values
+    void multiply(Field<float> const& x, Field<float>& Ax) const;
+
+private:
+
+    static constexpr Index chunkSize = 8;
+    static constexpr Index sortingWindow = 256;
+
+    LinearSolvers::SparseFormat::Type m_format = LinearSolvers::SparseFormat::CSR;
+    Index m_rows = 0;
+    Index m_cols = 0;
+
+    SparseMatrix const* m_matrix = nullptr;
+
+    bool m_singlePrecision = false;
+    SingleSparseMatrix m_singleMatrix;
+
+    // SELL-C-sigma storage, value j of lane l in chunk c is at m_chunkStarts[c] + j*chunkSize + l
+    List<Index> m_chunkStarts;
+    List<Scalar> m_values;
+    List<float> m_singleValues;
+    List<Index> m_columns;
+    // Original row of each lane, -1 for padding lanes of the last chunk
+    List<Index> m_laneRows;
+    // Position of the first value of each row, next ones follow with chunkSize stride
+    List<Index> m_rowOffsets;
+
+    // Pattern the layout was built for
+    List<Index> m_patternRowStarts;
+    List<Index> m_patternColumns;
+
+    bool patternMatches(SparseMatrix const& A) const;
+    void buildLayout(SparseMatrix const& A);
+    void updateSingleMatrix(SparseMatrix const& A);
+
+    template<class T, Index columnAmount>
+    void multiplyChunks(T const* chunkValues, T const* x, T* ax) const;
+};
@@ -1,6 +1,8 @@
 #include "MatrixSolver.h"
+#include "LinearSolvers/KrylovSolvers.h"
+#include "LinearSolvers/Preconditioners.h"
+#include "Timer.h"
 #include <Eigen/LU>
-#include <Eigen/IterativeLinearSolvers>
 #include <cassert>
 
 
@@ -11,13 +13,11 @@ void relaxSystem(SparseMatrix& A, Matrix& rhs, Field<Scalar> const& previousValu
     assert(rhs.rows() == previousValue.rows() && rhs.cols() == 1);
     assert(relaxFactor > 0);
 
-    auto Adiag = A.diagonal();
-    
-    for (Index idx = 0; idx < A.rows(); idx++)
-    {
-        rhs(idx) += (1/relaxFactor - 1) * Adiag(idx) * previousValue(idx);
-        Adiag(idx) /= relaxFactor;
-    }
+    // Each access to sparse diagonal searches the row, so it is read and written once
+    Field<Scalar> diagonal = A.diagonal();
+
+    rhs.col(0) += (1/relaxFactor - 1) * diagonal.cwiseProduct(previousValue);
+    A.diagonal() = diagonal / relaxFactor;
 }
 
 
@@ -28,13 +28,13 @@ void relaxSystem(SparseMatrix& A, Matrix& rhs, Field<Vector> const& previousValu
     assert(rhs.rows() == previousValue.rows() && rhs.cols() == 3);
     assert(relaxFactor > 0);
 
-    auto Adiag = A.diagonal();
-    
+    Field<Scalar> diagonal = A.diagonal();
+
     for (Index idx = 0; idx < A.rows(); idx++)
     {
-        rhs.row(idx) += (1/relaxFactor - 1) * Adiag(idx) * previousValue(idx).transpose();
-        Adiag(idx) /= relaxFactor;
+        rhs.row(idx) += (1/relaxFactor - 1) * diagonal(idx) * previousValue(idx).transpose();
     }
+    A.diagonal() = diagonal / relaxFactor;
 }
 
 
@@ -47,39 +47,78 @@ Matrix solveSystem(Matrix& A, Matrix const& rhs)
 }
 
 
-Matrix solveSystem(SparseMatrix& A, Matrix const& rhs, Scalar tolerance)
+Matrix solveSystem
+(
+    SparseMatrix& A,
+    Matrix const& rhs,
+    Scalar tolerance,
+    LinearSolvers::Solver::Type solverType,
+    LinearSolvers::Preconditioner::Type preconditionerType,
+    LinearSolveRecord* record
+)
 {
-    assert(A.cols() == A.rows());
-    assert(A.rows() == rhs.rows());
-
-    Eigen::BiCGSTAB<SparseMatrix> solver(A);
-    assert(solver.info() == Eigen::Success);
-
-    Matrix result;
-    solver.setTolerance(tolerance);
-    result = solver.solve(rhs);
+    Matrix guess = Matrix::Zero(rhs.rows(), rhs.cols());
+    return solveSystem(A, rhs, guess, tolerance, solverType, preconditionerType, record);
+}
 
-    assert(solver.info() == Eigen::Success);
 
-    return result;
+Matrix solveSystem
+(
+    SparseMatrix& A,
+    Matrix const& rhs,
+    Matrix const& guess,
+    Scalar tolerance,
+    LinearSolvers::Solver::Type solverType,
+    LinearSolvers::Preconditioner::Type preconditionerType,
+    LinearSolveRecord* record
+)
+{
+    auto preconditioner = makePreconditioner(preconditionerType);
+    return solveSystem(A, rhs, guess, tolerance, solverType, *preconditioner, record);
 }
 
 
-Matrix solveSystem(SparseMatrix& A, Matrix const& rhs, Matrix const& guess, Scalar tolerance)
+Matrix solveSystem
+(
+    SparseMatrix& A,
+    Matrix const& rhs,
+    Matrix const& guess,
+    Scalar tolerance,
+    LinearSolvers::Solver::Type solverType,
+    PreconditionerBase& preconditioner,
+    LinearSolveRecord* record
+)
 {
     assert(A.cols() == A.rows());
     assert(A.rows() == rhs.rows());
     assert(A.rows() == guess.rows());
     assert(rhs.cols() == guess.cols());
 
-    Eigen::BiCGSTAB<SparseMatrix> solver(A);
-    assert(solver.info() == Eigen::Success);
+    Timer setupTimer, solveTimer;
 
-    Matrix result;
-    solver.setTolerance(tolerance);
-    result = solver.solveWithGuess(rhs, guess);
+    setupTimer.start();
+    preconditioner.compute(A);
+    setupTimer.stop();
 
-    assert(solver.info() == Eigen::Success);
+    solveTimer.start();
+    auto solver = makeKrylovSolver(solverType);
+    solver->setTolerance(tolerance);
+
+    // A outlives the view
+    SparseOperator matrix(A);
+    Matrix result = guess;
+    bool converged = solver->solveBlock(matrix, preconditioner, rhs, result);
+    solveTimer.stop();
+
+    if (record)
+    {
+        record->iterations = solver->iterations();
+        record->error = solver->error();
+        record->converged = converged;
+        record->preconditionerUpdated = true;
+        record->setupTime = setupTimer.getElapsedTime();
+        record->solveTime = solveTimer.getElapsedTime();
+    }
 
     return result;
 }
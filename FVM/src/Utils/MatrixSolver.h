@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Types.h"
+#include "LinearSolvers/LinearSolverTypes.h"
+#include "LinearSolvers/Preconditioners.h"
+#include "LinearSolvers/LinearSolveRecord.h"
 
 
 // only for Matrix and SparseMatrix
@@ -9,5 +12,37 @@ void relaxSystem(SparseMatrix& A, Matrix& rhs, Field<Vector> const& previousValu
 
 Matrix solveSystem(Matrix& A, Matrix const& rhs);
 
-Matrix solveSystem(SparseMatrix& A, Matrix const& rhs, Scalar tolerance);
-Matrix solveSystem(SparseMatrix& A, Matrix const& rhs, Matrix const& guess, Scalar tolerance);
+// Columns of rhs are separate systems solved with the chosen Krylov solver and preconditioner,
+// statistics of the solve are written to record if it is given
+Matrix solveSystem
+(
+    SparseMatrix& A,
+    Matrix const& rhs,
+    Scalar tolerance,
+    LinearSolvers::Solver::Type solverType = LinearSolvers::Solver::BICGSTAB,
+    LinearSolvers::Preconditioner::Type preconditionerType = LinearSolvers::Preconditioner::JACOBI,
+    LinearSolveRecord* record = nullptr
+);
+
+Matrix solveSystem
+(
+    SparseMatrix& A,
+    Matrix const& rhs,
+    Matrix const& guess,
+    Scalar tolerance,
+    LinearSolvers::Solver::Type solverType = LinearSolvers::Solver::BICGSTAB,
+    LinearSolvers::Preconditioner::Type preconditionerType = LinearSolvers::Preconditioner::JACOBI,
+    LinearSolveRecord* record = nullptr
+);
+
+// Preconditioner is kept by the caller, so it can reuse its setup between calls
+Matrix solveSystem
+(
+    SparseMatrix& A,
+    Matrix const& rhs,
+    Matrix const& guess,
+    Scalar tolerance,
+    LinearSolvers::Solver::Type solverType,
+    PreconditionerBase& preconditioner,
+    LinearSolveRecord* record = nullptr
+);
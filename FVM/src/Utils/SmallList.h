@@ -0,0 +1,246 @@
+#pragma once
+
+#include "Types.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+
+
+// Vector-like container which keeps up to N elements inline,
+// heap is used only when size exceeds N
+template<class T, size_t N>
+class SmallList
+{
+public:
+
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = T const&;
+    using pointer         = T*;
+    using const_pointer   = T const*;
+    using iterator        = T*;
+    using const_iterator  = T const*;
+
+    SmallList() = default;
+
+    explicit SmallList(size_type count)
+    {
+        resize(count);
+    }
+
+    SmallList(std::initializer_list<T> list)
+    {
+        assign(list.begin(), list.end());
+    }
+
+    SmallList(SmallList const& other)
+    {
+        assign(other.begin(), other.end());
+    }
+
+    SmallList(SmallList&& other) noexcept
+    {
+        moveFrom(std::move(other));
+    }
+
+    ~SmallList()
+    {
+        clear();
+        deallocate();
+    }
+
+    SmallList& operator=(SmallList const& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallList& operator=(SmallList&& other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            deallocate();
+            moveFrom(std::move(other));
+        }
+        return *this;
+    }
+
+    SmallList& operator=(std::initializer_list<T> list)
+    {
+        clear();
+        assign(list.begin(), list.end());
+        return *this;
+    }
+
+    iterator       begin()       {return m_data;}
+    const_iterator begin() const {return m_data;}
+    iterator       end()         {return m_data + m_size;}
+    const_iterator end()   const {return m_data + m_size;}
+
+    T*       data()       {return m_data;}
+    T const* data() const {return m_data;}
+
+    size_type size()     const {return m_size;}
+    size_type capacity() const {return m_capacity;}
+    bool      empty()    const {return 0 == m_size;}
+
+    T&       operator[](size_type idx)       {return m_data[idx];}
+    T const& operator[](size_type idx) const {return m_data[idx];}
+
+    T&       back()       {return m_data[m_size-1];}
+    T const& back() const {return m_data[m_size-1];}
+
+    bool isInline() const
+    {
+        return m_data == inlineData();
+    }
+
+    void reserve(size_type newCapacity)
+    {
+        if (newCapacity <= m_capacity)
+        {
+            return;
+        }
+
+        T* newData = Allocator<T>().allocate(newCapacity);
+        std::uninitialized_move(begin(), end(), newData);
+        std::destroy(begin(), end());
+        deallocate();
+
+        m_data = newData;
+        m_capacity = newCapacity;
+    }
+
+    void resize(size_type count)
+    {
+        if (count < m_size)
+        {
+            std::destroy(begin() + count, end());
+        }
+        else
+        {
+            reserve(count);
+            std::uninitialized_value_construct(end(), m_data + count);
+        }
+        m_size = count;
+    }
+
+    void clear()
+    {
+        std::destroy(begin(), end());
+        m_size = 0;
+    }
+
+    template<class... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (m_size == m_capacity)
+        {
+            // arguments may refer to the elements which are moved on growing
+            T value(std::forward<Args>(args)...);
+            reserve(2*m_capacity);
+            return *std::construct_at(m_data + m_size++, std::move(value));
+        }
+        return *std::construct_at(m_data + m_size++, std::forward<Args>(args)...);
+    }
+
+    void push_back(T const& value)
+    {
+        emplace_back(value);
+    }
+
+    iterator insert(const_iterator position, T const& value)
+    {
+        size_type offset = position - begin();
+        if (offset == m_size)
+        {
+            emplace_back(value);
+            return begin() + offset;
+        }
+
+        T copy = value;
+        emplace_back(std::move(back()));
+        std::move_backward(begin() + offset, end() - 2, end() - 1);
+        m_data[offset] = std::move(copy);
+
+        return begin() + offset;
+    }
+
+    template<class Range>
+    friend bool operator==(SmallList const& lhs, Range const& rhs)
+    requires requires {std::size(rhs); std::begin(rhs);}
+    {
+        return
+        (
+            lhs.size() == static_cast<size_type>(std::size(rhs))
+            && std::equal(lhs.begin(), lhs.end(), std::begin(rhs))
+        );
+    }
+
+private:
+
+    alignas(T) std::byte m_buffer[N * sizeof(T)];
+    T* m_data = inlineData();
+    size_type m_size = 0;
+    size_type m_capacity = N;
+
+    T* inlineData()
+    {
+        return reinterpret_cast<T*>(m_buffer);
+    }
+
+    T const* inlineData() const
+    {
+        return reinterpret_cast<T const*>(m_buffer);
+    }
+
+    void deallocate()
+    {
+        if (!isInline())
+        {
+            Allocator<T>().deallocate(m_data, m_capacity);
+            m_data = inlineData();
+            m_capacity = N;
+        }
+    }
+
+    // expects empty inline container
+    template<class Iter>
+    void assign(Iter first, Iter last)
+    {
+        size_type count = std::distance(first, last);
+        reserve(count);
+        std::uninitialized_copy(first, last, m_data);
+        m_size = count;
+    }
+
+    // expects empty inline container
+    void moveFrom(SmallList&& other)
+    {
+        if (other.isInline())
+        {
+            std::uninitialized_move(other.begin(), other.end(), m_data);
+            m_size = other.m_size;
+            other.clear();
+            return;
+        }
+
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+
+        other.m_data = other.inlineData();
+        other.m_size = 0;
+        other.m_capacity = N;
+    }
+};
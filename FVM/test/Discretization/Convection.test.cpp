@@ -0,0 +1,71 @@
+#include "TestUtils.h"
+
+#include <Discretization/Interpolation.h>
+#include <Discretization/GradientOperator.h>
+#include <Mesh/2D/Structured/CartesianMesh2D.h>
+
+#include <gtest/gtest.h>
+
+
+TEST(TestConvection, DeferredCorrectionMatchesImplicitScheme)
+{
+    using namespace Interpolation::Schemes;
+
+    CartesianMesh2D mesh(6, 5, 1.2, 0.5);
+
+    List<BoundaryCondition<Vector>> boundaries(mesh.getFaceAmount());
+    for (Index faceIdx = 0; faceIdx < mesh.getFaceAmount(); faceIdx++)
+    {
+        boundaries[faceIdx] =
+        (
+            faceIdx % 3
+            ? BoundaryCondition<Vector>::fixedValue(randomVector())
+            : BoundaryCondition<Vector>::fixedGradient(randomVector())
+        );
+    }
+    BoundaryConditionGetter<Vector> boundaryGetter = [&boundaries](Index faceIdx)
+    {
+        return boundaries[faceIdx];
+    };
+
+    Field<Vector> velocity(mesh.getCellAmount());
+    for (Index cellIdx = 0; cellIdx < mesh.getCellAmount(); cellIdx++)
+    {
+        velocity(cellIdx) = randomVector();
+    }
+
+    Field<Scalar> massFlow(mesh.getFaceAmount());
+    for (Index faceIdx = 0; faceIdx < mesh.getFaceAmount(); faceIdx++)
+    {
+        massFlow(faceIdx) = randomScalar();
+    }
+
+    for (bool nonOrthogonalCorrection : {false, true})
+    {
+        mesh.useNonOrthogonalCorrection = nonOrthogonalCorrection;
+        auto gradientScheme = (nonOrthogonalCorrection ? Gradient::LEAST_SQAURE : Gradient::GREEN_GAUSE);
+        Field<Tensor> velocityGradient = GradientOperator<Vector>(mesh, boundaryGetter, gradientScheme).evaluate(velocity);
+
+        using enum Convection::Type;
+        for (auto schemeType : {CENTRAL_DIFFERENCE, UPWIND, DOWNWIND, FROMM, SOU, QUICK})
+        {
+            for (Index cellIdx = 0; cellIdx < mesh.getCellAmount(); cellIdx++)
+            {
+                Vector expected = Interpolation::computeConvectionFluxOverCell
+                (
+                    mesh, cellIdx, boundaryGetter, massFlow, schemeType
+                )
+                .evaluate(velocity);
+
+                Vector deferred = Interpolation::computeDeferredConvectionFluxOverCell
+                (
+                    mesh, cellIdx, boundaryGetter, massFlow, schemeType, velocity, velocityGradient
+                )
+                .evaluate(velocity);
+
+                EXPECT_LT((expected - deferred).norm(), 1e-8 * std::max(expected.norm(), Scalar(1)))
+                    << "scheme " << schemeType << ", cell idx is " << cellIdx;
+            }
+        }
+    }
+}
@@ -2,6 +2,7 @@
 #include "TestPrinting.h"
 
 #include <Discretization/Interpolation.h>
+#include <Discretization/GradientOperator.h>
 #include <Mesh/2D/Structured/CartesianMesh2D.h>
 
 #include <gtest/gtest.h>
@@ -77,3 +78,52 @@ TEST(TestGradient, LeastSquareScalarInteriorCell)
 
     EXPECT_EQ(gradient, expectedGradient);
 }
+
+
+template<class T>
+void testGradientOperator(Interpolation::Schemes::Gradient::Type schemeType, T (*randomValue)())
+{
+    CartesianMesh2D mesh(5, 4, 1.0, 0.8);
+
+    List<BoundaryCondition<T>> boundaries(mesh.getFaceAmount());
+    for (Index faceIdx = 0; faceIdx < mesh.getFaceAmount(); faceIdx++)
+    {
+        boundaries[faceIdx] =
+        (
+            faceIdx % 2
+            ? BoundaryCondition<T>::fixedValue(randomValue())
+            : BoundaryCondition<T>::fixedGradient(randomValue())
+        );
+    }
+    BoundaryConditionGetter<T> boundaryGetter = [&boundaries](Index faceIdx)
+    {
+        return boundaries[faceIdx];
+    };
+
+    Field<T> field(mesh.getCellAmount());
+    for (Index cellIdx = 0; cellIdx < mesh.getCellAmount(); cellIdx++)
+    {
+        field(cellIdx) = randomValue();
+    }
+
+    GradientOperator<T> gradientOperator(mesh, boundaryGetter, schemeType);
+    auto gradient = gradientOperator.evaluate(field);
+
+    ASSERT_EQ(gradient.rows(), mesh.getCellAmount());
+    for (Index cellIdx = 0; cellIdx < mesh.getCellAmount(); cellIdx++)
+    {
+        auto expected = Interpolation::computeCellGradient(mesh, cellIdx, boundaryGetter, schemeType).evaluate(field);
+        EXPECT_LT((gradient(cellIdx) - expected).norm(), 1e-9) << "cell idx is " << cellIdx;
+    }
+}
+
+TEST(TestGradient, GradientOperatorMatchesCellGradient)
+{
+    using namespace Interpolation::Schemes::Gradient;
+
+    for (auto schemeType : {GREEN_GAUSE, LEAST_SQAURE})
+    {
+        testGradientOperator<Scalar>(schemeType, &randomScalar);
+        testGradientOperator<Vector>(schemeType, &randomVector);
+    }
+}
@@ -1,5 +1,6 @@
 #include "TestUtils.h"
 #include <Discretization/LinearCombination.h>
+#include <Discretization/LinearExpression.h>
 #include <algorithm>
 #include <gtest/gtest.h>
 
@@ -342,4 +343,58 @@ TEST(TestLinearCombination, DotProductOnVectorVariable)
     EXPECT_EQ(slc.bias, t * v3);
     sortIndices(slc);
     EXPECT_EQ(slc.terms, List<Term<Scalar>>({{v2.dot(v3), 0}, {v3.dot(v4), 2}, {v3.dot(v5), 4}}));
-}
\ No newline at end of file
+}
+
+TEST(TestLinearCombination, ManyTerms)
+{
+    constexpr Index sz = 3 * LinearCombination<Scalar>::inlineTermsAmount;
+
+    LinearCombination<Scalar> lc1, lc2;
+    List<Term<Scalar>>        expectedTerms;
+    for (Index idx = 0; idx < sz; idx++)
+    {
+        // adding in reverse order to check sorted insertion
+        lc1 += Term<Scalar>{Scalar(idx), sz - 1 - idx};
+        lc2 -= Term<Scalar>{Scalar(2 * idx), idx};
+        expectedTerms.push_back({Scalar(sz - 1 - idx) - 2 * idx, idx});
+    }
+    EXPECT_EQ(lc1.terms.size(), sz);
+    EXPECT_TRUE(std::is_sorted(lc1.terms.begin(), lc1.terms.end(), [](auto t1, auto t2) { return t1.idx < t2.idx; }));
+
+    auto lc = lc1 + lc2;
+    EXPECT_EQ(lc.terms, expectedTerms);
+
+    LinearCombination<Scalar> copy = lc;
+    lc += copy;
+    lc -= copy;
+    EXPECT_EQ(lc.terms, expectedTerms);
+
+    LinearCombination<Scalar> moved = std::move(lc);
+    EXPECT_EQ(moved.terms, expectedTerms);
+}
+
+TEST(TestLinearCombination, LazyExpression)
+{
+    LinearCombination<Scalar, Scalar> value = {{1, 2}};
+    value += 2;
+    LinearCombination<Scalar, Vector> grad1 = {{{1, -2, 0.5}, 1}, {{-0.5, 4, 2}, 2}};
+    grad1 += Vector(1, 0, -1);
+    LinearCombination<Scalar, Vector> grad2 = {{{0.25, 1, -1}, 2}, {{2, 2, 2}, 5}};
+    Vector delta(0.5, -1, 2);
+
+    LinearCombination<Scalar, Scalar> expected = value + Scalar(0.5) * (Scalar(2) * grad1 - grad2).dot(delta);
+    LinearCombination<Scalar, Scalar> result = lazy(value) + Scalar(0.5) * (Scalar(2) * lazy(grad1) - grad2).dot(delta);
+    EXPECT_EQ(result, expected);
+
+    LinearCombination<Scalar, Vector> vexpected = grad1 + (value - grad2.dot(delta)) * delta;
+    LinearCombination<Scalar, Vector> vresult = lazy(grad1) + (value - lazy(grad2).dot(delta)) * delta;
+    EXPECT_EQ(vresult, vexpected);
+
+    vexpected += delta * value / 4 - grad1;
+    vresult += delta * lazy(value) / 4 - grad1;
+    EXPECT_EQ(vresult, vexpected);
+
+    vexpected -= -grad2 + Vector(1, 1, 1);
+    vresult -= -lazy(grad2) + Vector(1, 1, 1);
+    EXPECT_EQ(vresult, vexpected);
+}
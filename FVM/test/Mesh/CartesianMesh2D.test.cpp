@@ -140,6 +140,63 @@ TEST_P(TestCartesinaMesh2D, FaceNeighborsArrayTest)
     }
 }
 
+TEST_P(TestCartesinaMesh2D, FaceGeometryTest)
+{
+    for (Index faceIdx = 0; faceIdx < totalFaces; faceIdx++)
+    {
+        bool   isHorizontal = faceIdx % (2 * nx + 1) < nx;
+        Scalar expectedArea = (isHorizontal ? dx : dy);
+        Scalar expectedDistance = (isHorizontal ? dy : dx);
+
+        EXPECT_NEAR(getFaceArea(faceIdx), expectedArea, tolerance) << "face idx is " << faceIdx;
+        EXPECT_LT((getFaceUnitNormal(faceIdx) - getFaceVector(faceIdx) / expectedArea).norm(), tolerance)
+            << "face idx is " << faceIdx;
+
+        auto [ownerDistance, neighborDistance] = getFaceCellDistances(faceIdx);
+        EXPECT_NEAR(ownerDistance, expectedDistance / 2, tolerance) << "face idx is " << faceIdx;
+
+        if (isBoundaryFace(faceIdx))
+        {
+            EXPECT_NEAR(getFaceWeight(faceIdx), 1, tolerance) << "face idx is " << faceIdx;
+            continue;
+        }
+
+        auto [ownerIdx, neighborIdx] = getFaceNeighbors(faceIdx);
+        Vector expectedDirection = getCellCentroid(neighborIdx) - getCellCentroid(ownerIdx);
+
+        EXPECT_NEAR(neighborDistance, expectedDistance / 2, tolerance) << "face idx is " << faceIdx;
+        EXPECT_NEAR(getFaceCellToCellDistance(faceIdx), expectedDistance, tolerance) << "face idx is " << faceIdx;
+        EXPECT_LT((getFaceCellToCellUnitVector(faceIdx) - expectedDirection / expectedDistance).norm(), tolerance)
+            << "face idx is " << faceIdx;
+        EXPECT_NEAR(getFaceWeight(faceIdx), 0.5, tolerance) << "face idx is " << faceIdx;
+    }
+}
+
+TEST_P(TestCartesinaMesh2D, FaceColorsTest)
+{
+    List<Index> faceColor(totalFaces, -1);
+
+    for (Index color = 0; color < (Index)getFaceColors().size(); color++)
+    {
+        List<bool> isCellUsed(totalCells, false);
+        for (Index faceIdx : getFaceColors()[color])
+        {
+            EXPECT_EQ(faceColor[faceIdx], -1) << "face idx is " << faceIdx;
+            faceColor[faceIdx] = color;
+
+            for (Index cellIdx : getFaceNeighbors(faceIdx))
+            {
+                if (cellIdx == -1)
+                    continue;
+                EXPECT_FALSE(isCellUsed[cellIdx]) << "cell idx is " << cellIdx << ", color is " << color;
+                isCellUsed[cellIdx] = true;
+            }
+        }
+    }
+
+    EXPECT_EQ(std::count(faceColor.begin(), faceColor.end(), -1), 0);
+}
+
 TEST_P(TestCartesinaMesh2D, LeftBoundariesTest)
 {
     using enum BoundaryConditionType;
@@ -188,6 +245,99 @@ TEST_P(TestCartesinaMesh2D, BottomBoundariesTest)
         EXPECT_MAP_VALUE(m_boundariesMap, faceIdx, boundaries);
 }
 
+TEST_P(TestCartesinaMesh2D, BoundaryTablesTest)
+{
+    using enum BoundaryConditionType;
+    Boundaries wall = Boundaries::wall();
+    Boundaries outlet = Boundaries::outlet(2);
+    Boundaries inlet = Boundaries::inlet({1, 0, 0});
+
+    setTopBoundary(wall);
+    setBottomBoundary(wall);
+    setLeftBoundary(inlet);
+    setRightBoundary(outlet);
+    // overriding already set conditions
+    setTopBoundary(inlet);
+
+    auto const& uBoundaries = getVelocityBoundaries();
+    auto const& pBoundaries = getPressureBoundaries();
+    auto        pCorrBoundaries = pBoundaries.homogeneous();
+    EXPECT_EQ(uBoundaries.size(), m_boundariesMap.size());
+    EXPECT_EQ(pBoundaries.size(), m_boundariesMap.size());
+
+    for (Index faceIdx = 0; faceIdx < totalFaces; faceIdx++)
+    {
+        EXPECT_EQ(uBoundaries.contains(faceIdx), isBoundaryFace(faceIdx));
+        if (isBoundaryFace(faceIdx))
+        {
+            Boundaries boundaries = m_boundariesMap.at(faceIdx);
+            EXPECT_EQ(uBoundaries(faceIdx), boundaries.uBoundary);
+            EXPECT_EQ(pBoundaries(faceIdx), boundaries.pBoundary);
+            EXPECT_EQ(getFaceBoundary(faceIdx), boundaries);
+            EXPECT_EQ(pCorrBoundaries(faceIdx).value, 0);
+        }
+    }
+}
+
+TEST_P(TestCartesinaMesh2D, RenumberedFacesTest)
+{
+    CartesianMesh2D mesh(nx, ny, nx * dx, ny * dy, true);
+    Boundaries      wall = Boundaries::wall();
+    Boundaries      inlet = Boundaries::inlet({1, 0, 0});
+    mesh.setTopBoundary(wall);
+    mesh.setBottomBoundary(wall);
+    mesh.setLeftBoundary(inlet);
+    mesh.setRightBoundary(wall);
+
+    ASSERT_TRUE(mesh.isRenumbered());
+    EXPECT_FALSE(isRenumbered());
+    ASSERT_EQ(mesh.getFaceAmount(), totalFaces);
+
+    Index interiorFaces = 2 * nx * ny - nx - ny;
+    EXPECT_EQ(mesh.getInteriorFaceAmount(), interiorFaces);
+    EXPECT_EQ(getInteriorFaceAmount(), interiorFaces);
+    for (Index faceIdx = 0; faceIdx < totalFaces; faceIdx++)
+        EXPECT_EQ(mesh.isBoundaryFace(faceIdx), faceIdx >= interiorFaces) << "face idx is " << faceIdx;
+
+    // top, bottom, left, right
+    List<Array<Index, 2>> expectedPatches = {{interiorFaces, interiorFaces + nx},
+                                             {interiorFaces + nx, interiorFaces + 2 * nx},
+                                             {interiorFaces + 2 * nx, interiorFaces + 2 * nx + ny},
+                                             {interiorFaces + 2 * nx + ny, totalFaces}};
+    EXPECT_EQ(mesh.getBoundaryPatches(), expectedPatches);
+
+    auto const& left = expectedPatches[2];
+    for (Index faceIdx = left[0]; faceIdx < left[1]; faceIdx++)
+    {
+        EXPECT_EQ(mesh.getFaceBoundary(faceIdx), inlet);
+        EXPECT_LT(std::abs(mesh.getFaceCentroid(faceIdx).x()), tolerance);
+    }
+    for (Index faceIdx = left[1]; faceIdx < totalFaces; faceIdx++)
+        EXPECT_EQ(mesh.getFaceBoundary(faceIdx), wall);
+
+    // colors cover exactly the interior faces
+    List<Index> faceColorAmount(totalFaces, 0);
+    for (auto const& faces : mesh.getFaceColors())
+        for (Index faceIdx : faces)
+            faceColorAmount[faceIdx]++;
+    for (Index faceIdx = 0; faceIdx < totalFaces; faceIdx++)
+        EXPECT_EQ(faceColorAmount[faceIdx], faceIdx < interiorFaces ? 1 : 0) << "face idx is " << faceIdx;
+
+    // same cells with the renumbered faces
+    for (Index cellIdx = 0; cellIdx < totalCells; cellIdx++)
+    {
+        auto const& faces = getCellFaces(cellIdx);
+        auto const& renumbered = mesh.getCellFaces(cellIdx);
+        ASSERT_EQ(faces.size(), renumbered.size());
+        for (size_t i = 0; i < faces.size(); i++)
+        {
+            EXPECT_LT((getFaceCentroid(faces[i]) - mesh.getFaceCentroid(renumbered[i])).norm(), tolerance);
+            EXPECT_LT((getFaceVector(faces[i]) - mesh.getFaceVector(renumbered[i])).norm(), tolerance);
+            EXPECT_EQ(getFaceNeighbors(faces[i]), mesh.getFaceNeighbors(renumbered[i]));
+        }
+    }
+}
+
 INSTANTIATE_TEST_SUITE_P
 (
     TestParamTest,
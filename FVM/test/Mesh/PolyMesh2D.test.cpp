@@ -161,4 +161,42 @@ TEST_F(TestPolyMesh2D, BoundariesTest)
     // right
     for (Index faceIdx = 2 * nx; faceIdx < totalFaces; faceIdx += 2 * nx + 1)
         EXPECT_MAP_VALUE(m_boundariesMap, faceIdx, rightBoundaries);
-}
\ No newline at end of file
+}
+TEST_F(TestPolyMesh2D, RenumberedFacesTest)
+{
+    PolyMesh2D mesh(std::stringstream(
+#include "poiseuille_unifrom_11x15.msh"
+                        ),
+                    true);
+
+    ASSERT_TRUE(mesh.isRenumbered());
+    ASSERT_EQ(mesh.getFaceAmount(), totalFaces);
+    EXPECT_EQ(mesh.getInteriorFaceAmount(), getInteriorFaceAmount());
+
+    for (Index faceIdx = 0; faceIdx < totalFaces; faceIdx++)
+        EXPECT_EQ(mesh.isBoundaryFace(faceIdx), faceIdx >= mesh.getInteriorFaceAmount()) << "face idx is " << faceIdx;
+
+    // top and bottom are equal walls, then left and right
+    auto const& patches = mesh.getBoundaryPatches();
+    ASSERT_EQ(patches.size(), 3);
+    EXPECT_EQ(patches[0], (Array<Index, 2>{mesh.getInteriorFaceAmount(), mesh.getInteriorFaceAmount() + 2 * nx}));
+    EXPECT_EQ(patches[1][1] - patches[1][0], ny);
+    EXPECT_EQ(patches[2][1], totalFaces);
+
+    for (auto [patchBegin, patchEnd] : patches)
+        for (Index faceIdx = patchBegin; faceIdx < patchEnd; faceIdx++)
+            EXPECT_EQ(mesh.getFaceBoundary(faceIdx), mesh.getFaceBoundary(patchBegin)) << "face idx is " << faceIdx;
+
+    // cells are still closed and faces point outwards from the owner
+    for (Index cellIdx = 0; cellIdx < totalCells; cellIdx++)
+    {
+        Vector sum = {0, 0, 0};
+        for (Index faceIdx : mesh.getCellFaces(cellIdx))
+        {
+            Vector faceVector = mesh.getFaceVector(faceIdx);
+            sum += (mesh.getFaceOwner(faceIdx) == cellIdx ? faceVector : Vector(-faceVector));
+            EXPECT_GT(faceVector.dot(mesh.getFaceCentroid(faceIdx) - mesh.getCellCentroid(mesh.getFaceOwner(faceIdx))), 0);
+        }
+        EXPECT_LT(sum.norm(), tolerance) << "cell idx is " << cellIdx;
+    }
+}
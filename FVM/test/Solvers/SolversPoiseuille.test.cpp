@@ -2,9 +2,14 @@
 #include "TestUtils.h"
 
 #include "Solvers/SIMPLE/SimpleAlgorithm.h"
+#include "Solvers/PISO/PisoAlgorithm.h"
+#include "Solvers/Coupled/CoupledAlgorithm.h"
 #include "Mesh/2D/Structured/CartesianMesh2D.h"
 #include "Config/Config.h"
 
+#include <filesystem>
+#include <fstream>
+
 
 class PoiseuilleFixture : public testing::Test
 {
@@ -23,16 +28,39 @@ protected:
 
     static constexpr Scalar uRelax = 0.7;
     static constexpr Scalar pRelax = 0.3;
+    static constexpr Scalar coupledURelax = 1;
     
     static constexpr Scalar uTolerance = 1e-5;
     static constexpr Scalar pTolerance = 1e-7;
     static constexpr Index maxIterations = 10'000;
+    static constexpr Index pisoCorrectors = 2;
+    static constexpr bool simplec = false;
+
+    static constexpr Scalar timeStep = 0;
+    static constexpr Scalar timeBegin = 0;
+    static constexpr Scalar timeEnd = 0;
+    static constexpr Index snapshotInterval = 1;
+    static constexpr bool adaptiveTimeStep = false;
+    static constexpr Scalar targetCourant = 1;
+    static constexpr Scalar minTimeStep = 0;
+    static constexpr Scalar maxTimeStep = 1;
 
     static constexpr auto convectionScheme = Interpolation::Schemes::Convection::SOU;
     static constexpr auto gradientScheme = Interpolation::Schemes::Gradient::GREEN_GAUSE;
+    static constexpr bool deferredCorrection = false;
 
+    static constexpr auto uSolver = LinearSolvers::Solver::BICGSTAB;
+    static constexpr auto uPreconditioner = LinearSolvers::Preconditioner::JACOBI;
+    static constexpr auto pSolver = LinearSolvers::Solver::BICGSTAB;
+    static constexpr auto pPreconditioner = LinearSolvers::Preconditioner::JACOBI;
+    static constexpr bool mixedPrecision = false;
+    static constexpr bool adaptiveSystemTolerance = false;
+    static constexpr Scalar coupledSystemTolerance = 1e-3;
+    static constexpr Index maxSystemIterations = 0;
+    static constexpr auto linearSolverLog = "";
 
-    PoiseuilleFixture() : m_mesh(nx, ny, lx, ly)
+
+    PoiseuilleFixture() : m_mesh(nx, ny, lx, ly, true)
     {
         m_mesh.setLeftBoundary(Boundaries::outlet(inletPressure));
         m_mesh.setRightBoundary(Boundaries::outlet(outletPressure));
@@ -44,13 +72,36 @@ protected:
 
         Config::uRelax = uRelax;
         Config::pRelax = pRelax;
+        Config::coupledURelax = coupledURelax;
 
         Config::uTolerance = uTolerance;
         Config::pTolerance = pTolerance;
         Config::maxIterations = maxIterations;
+        Config::pisoCorrectors = pisoCorrectors;
+        Config::simplec = simplec;
+
+        Config::timeStep = timeStep;
+        Config::timeBegin = timeBegin;
+        Config::timeEnd = timeEnd;
+        Config::snapshotInterval = snapshotInterval;
+        Config::adaptiveTimeStep = adaptiveTimeStep;
+        Config::targetCourant = targetCourant;
+        Config::minTimeStep = minTimeStep;
+        Config::maxTimeStep = maxTimeStep;
 
         Config::convectionScheme = convectionScheme;
         Config::gradientScheme = gradientScheme;
+        Config::deferredCorrection = deferredCorrection;
+
+        Config::uSolver = uSolver;
+        Config::uPreconditioner = uPreconditioner;
+        Config::pSolver = pSolver;
+        Config::pPreconditioner = pPreconditioner;
+        Config::mixedPrecision = mixedPrecision;
+        Config::adaptiveSystemTolerance = adaptiveSystemTolerance;
+        Config::coupledSystemTolerance = coupledSystemTolerance;
+        Config::maxSystemIterations = maxSystemIterations;
+        Config::linearSolverLog = linearSolverLog;
     }
 
     template<class Solver>
@@ -58,8 +109,14 @@ protected:
     {
         Solver solver(m_mesh);
         solver.solve();
+        testSolution(solver);
+    }
 
+    // Checks the last time point against the analytical solution
+    void testSolution(SolverBase const& solver) const
+    {
         ASSERT_TRUE(solver.isConverged());
+        Index timePointIdx = solver.getTimePointAmount() - 1;
 
         for (Index cellIdx = 0; cellIdx < m_mesh.getCellAmount(); cellIdx++)
         {
@@ -71,8 +128,8 @@ protected:
             Scalar maxVelocity = (inletPressure - outletPressure) * ly * ly / (8 * viscosity * lx);
             Vector expectedVelocity = {maxVelocity * (1 - std::pow(y / (ly / 2), 2)), 0, 0};
     
-            auto const& pressureField = solver.getPressure(0);
-            auto const& velocityField = solver.getVelocity(0);
+            auto const& pressureField = solver.getPressure(timePointIdx);
+            auto const& velocityField = solver.getVelocity(timePointIdx);
 
             Vector velocity = velocityField(cellIdx);
             Vector diff = expectedVelocity - velocity;
@@ -92,3 +149,242 @@ TEST_F(PoiseuilleFixture, TestSimpleAlgorithm)
 {
     testSolver<SimpleAlgorithm>();
 }
+
+
+TEST_F(PoiseuilleFixture, TestSolverNeedsRenumberedMesh)
+{
+    CartesianMesh2D mesh(nx, ny, lx, ly);
+    EXPECT_THROW(SimpleAlgorithm{mesh}, std::invalid_argument);
+    EXPECT_THROW(CoupledAlgorithm{mesh}, std::invalid_argument);
+}
+
+
+TEST_F(PoiseuilleFixture, TestSimpleAlgorithmDeferredCorrection)
+{
+    Config::deferredCorrection = true;
+    testSolver<SimpleAlgorithm>();
+}
+
+
+TEST_F(PoiseuilleFixture, TestSimpleAlgorithmKrylovSolvers)
+{
+    Config::uSolver = LinearSolvers::Solver::GMRES;
+    Config::uPreconditioner = LinearSolvers::Preconditioner::ILU0;
+    Config::pSolver = LinearSolvers::Solver::CG;
+    Config::pPreconditioner = LinearSolvers::Preconditioner::IC0;
+    testSolver<SimpleAlgorithm>();
+}
+
+
+TEST_F(PoiseuilleFixture, TestSimpleAlgorithmAlgebraicMultigrid)
+{
+    Config::pSolver = LinearSolvers::Solver::CG;
+    Config::pPreconditioner = LinearSolvers::Preconditioner::AMG;
+    testSolver<SimpleAlgorithm>();
+}
+
+
+TEST_F(PoiseuilleFixture, TestSimpleAlgorithmGeometricMultigrid)
+{
+    Config::pSolver = LinearSolvers::Solver::CG;
+    Config::pPreconditioner = LinearSolvers::Preconditioner::GMG;
+    testSolver<SimpleAlgorithm>();
+}
+
+
+TEST_F(PoiseuilleFixture, TestSimpleAlgorithmMixedPrecision)
+{
+    Config::mixedPrecision = true;
+    testSolver<SimpleAlgorithm>();
+}
+
+
+TEST_F(PoiseuilleFixture, TestSimpleAlgorithmDirectPressure)
+{
+    Config::pSolver = LinearSolvers::Solver::RICHARDSON;
+    Config::pPreconditioner = LinearSolvers::Preconditioner::LDLT;
+    testSolver<SimpleAlgorithm>();
+}
+
+
+TEST_F(PoiseuilleFixture, TestSimpleAlgorithmAdaptiveSystemTolerance)
+{
+    Config::adaptiveSystemTolerance = true;
+    Config::maxSystemIterations = 50;
+    testSolver<SimpleAlgorithm>();
+}
+
+
+TEST_F(PoiseuilleFixture, TestSimpleAlgorithmSkipsZVelocity)
+{
+    SimpleAlgorithm solver(m_mesh);
+    solver.solve();
+    ASSERT_TRUE(solver.isConverged());
+
+    // Only x and y columns of the momentum system are passed to the linear solver
+    EXPECT_EQ(solver.getLinearSolveSummary("momentum").last.columns, m_mesh.getDimension());
+    EXPECT_EQ(solver.getLinearSolveSummary("pressure").last.columns, 1);
+
+    auto const& velocity = solver.getVelocity(solver.getTimePointAmount() - 1);
+    for (Index cellIdx = 0; cellIdx < m_mesh.getCellAmount(); cellIdx++)
+        EXPECT_EQ(velocity(cellIdx).z(), 0) << "cell idx is " << cellIdx;
+}
+
+
+TEST_F(PoiseuilleFixture, TestSimpleAlgorithmLinearSolveLog)
+{
+    std::filesystem::path logPath = std::filesystem::temp_directory_path() / "poiseuille_linear_solves.csv";
+    Config::linearSolverLog = logPath.string();
+
+    SimpleAlgorithm solver(m_mesh);
+    solver.solve();
+    ASSERT_TRUE(solver.isConverged());
+
+    auto const& momentumSolves = solver.getLinearSolveSummary("momentum");
+    auto const& pressureSolves = solver.getLinearSolveSummary("pressure");
+    ASSERT_GT(pressureSolves.solveAmount, 0);
+    EXPECT_EQ(momentumSolves.solveAmount, pressureSolves.solveAmount);
+    EXPECT_EQ(solver.getLinearSolveSummary("energy").solveAmount, 0);
+    EXPECT_EQ(pressureSolves.unconvergedAmount, 0);
+    EXPECT_GE(pressureSolves.totalIterations, pressureSolves.last.iterations);
+    EXPECT_GE(pressureSolves.solveTime, pressureSolves.last.solveTime);
+
+    // Header and a line per solve
+    std::ifstream log(logPath);
+    Index lineAmount = 0;
+    for (std::string line; std::getline(log, line);)
+    {
+        lineAmount++;
+    }
+    EXPECT_EQ(lineAmount, 1 + momentumSolves.solveAmount + pressureSolves.solveAmount);
+    std::filesystem::remove(logPath);
+}
+
+
+TEST_F(PoiseuilleFixture, TestSimpleAlgorithmSIMPLEC)
+{
+    SimpleAlgorithm simple(m_mesh);
+    simple.solve();
+    testSolution(simple);
+
+    Config::simplec = true;
+    for (Scalar simplecURelax : {0.5, 0.7})
+    {
+        SCOPED_TRACE(testing::Message() << "uRelax " << simplecURelax);
+        Config::uRelax = simplecURelax;
+
+        SimpleAlgorithm simplec(m_mesh);
+        simplec.solve();
+        testSolution(simplec);
+    }
+
+    // Pressure correction is not relaxed, so SIMPLEC tolerates weak velocity relaxation
+    Config::uRelax = 0.9;
+    SimpleAlgorithm simplec(m_mesh);
+    simplec.solve();
+    testSolution(simplec);
+
+    EXPECT_LT(simplec.getLinearSolveSummary("pressure").solveAmount, simple.getLinearSolveSummary("pressure").solveAmount);
+}
+
+
+TEST_F(PoiseuilleFixture, TestPisoAlgorithm)
+{
+    // Lighter fluid reaches the steady state in a few viscous time scales
+    Config::density = 1;
+    Config::timeStep = 5e-3;
+    Config::timeEnd = 0.5;
+
+    PisoAlgorithm solver(m_mesh);
+    solver.solve();
+    testSolution(solver);
+
+    // One momentum and a pressure solve per corrector on each time step
+    Index timeStepAmount = solver.getTimePointAmount() - 1;
+    EXPECT_EQ(solver.getLinearSolveSummary("momentum").solveAmount, timeStepAmount);
+    EXPECT_EQ(solver.getLinearSolveSummary("pressure").solveAmount, timeStepAmount * Config::pisoCorrectors);
+}
+
+
+TEST_F(PoiseuilleFixture, TestSimpleAlgorithmAdaptiveTimeStep)
+{
+    // Flow starts from rest, so the step grows until the Courant number limits it
+    Config::density = 1;
+    Config::timeStep = 1e-3;
+    Config::timeEnd = 0.5;
+    Config::adaptiveTimeStep = true;
+    Config::targetCourant = 2e-3;
+
+    SimpleAlgorithm solver(m_mesh);
+    solver.setTransient(true);
+    solver.solve();
+    testSolution(solver);
+
+    auto const& history = solver.getTimeStepHistory();
+    ASSERT_FALSE(history.empty());
+    EXPECT_EQ(history.front().timeStep, Config::timeStep);
+    for (size_t idx = 1; idx < history.size(); idx++)
+    {
+        EXPECT_LE(history[idx].timeStep, 1.2 * history[idx-1].timeStep * (1 + 1e-12));
+        EXPECT_LE(history[idx].courant, 1.1 * Config::targetCourant);
+    }
+    // Fixed first step would need 500 steps
+    EXPECT_LT(history.size(), 100);
+}
+
+
+TEST_F(PoiseuilleFixture, TestSnapshotSinks)
+{
+    Config::density = 1;
+    Config::timeStep = 5e-3;
+    Config::timeEnd = 0.5;
+    Config::snapshotInterval = 10;
+    auto snapshotPath = std::filesystem::temp_directory_path() / "poiseuille_snapshots.csv";
+
+    PisoAlgorithm solver(m_mesh);
+    Index timePointAmount = 0;
+    Scalar lastTime = 0;
+    solver.addSnapshotSink(std::make_unique<CallbackSnapshotSink>
+    (
+        [&](Index timePointIdx, Scalar time, Field<Vector> const&, Field<Scalar> const&)
+        {
+            EXPECT_EQ(timePointIdx, timePointAmount);
+            timePointAmount++;
+            lastTime = time;
+        }
+    ));
+    solver.addSnapshotSink(std::make_unique<CsvSnapshotSink>(snapshotPath.string()));
+    solver.solve();
+
+    // Every 10-th time point and the last one are in memory
+    testSolution(solver);
+    Index keptAmount = (timePointAmount - 1) / 10 + 1 + bool((timePointAmount - 1) % 10);
+    EXPECT_EQ(solver.getTimePointAmount(), keptAmount);
+    EXPECT_NEAR(solver.getTime(1), 10 * Config::timeStep, 1e-12);
+    EXPECT_EQ(solver.getTime(keptAmount - 1), lastTime);
+
+    std::ifstream snapshotFile(snapshotPath);
+    Index lineAmount = 0;
+    for (std::string line; std::getline(snapshotFile, line);)
+    {
+        lineAmount++;
+    }
+    EXPECT_EQ(lineAmount, 1 + timePointAmount * m_mesh.getCellAmount());
+    std::filesystem::remove(snapshotPath);
+}
+
+
+TEST_F(PoiseuilleFixture, TestCoupledAlgorithm)
+{
+    SimpleAlgorithm simple(m_mesh);
+    simple.solve();
+
+    CoupledAlgorithm coupled(m_mesh);
+    coupled.solve();
+    testSolution(coupled);
+
+    // One block solve per outer iteration
+    Index simpleIterations = simple.getLinearSolveSummary("pressure").solveAmount;
+    Index coupledIterations = coupled.getLinearSolveSummary("coupled").solveAmount;
+    EXPECT_LT(5 * coupledIterations, simpleIterations);
+}
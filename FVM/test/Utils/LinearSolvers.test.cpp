@@ -0,0 +1,627 @@
+#include "TestUtils.h"
+
+#include <Utils/MatrixSolver.h>
+#include <Utils/LinearSolvers/KrylovSolvers.h>
+#include <Utils/LinearSolvers/Preconditioners.h>
+#include <Utils/LinearSolvers/AlgebraicMultigrid.h>
+#include <Utils/LinearSolvers/GeometricMultigrid.h>
+#include <Utils/LinearSolvers/LinearSolver.h>
+#include <Utils/LinearSolvers/DirectSolvers.h>
+#include <Utils/LinearSolvers/ForcingTerm.h>
+#include <Utils/LinearSolvers/SparseKernels.h>
+#include <Utils/LinearSolvers/SparseOperator.h>
+
+#include <gtest/gtest.h>
+
+
+// 5-point stencil on n x n grid with Dirichlet boundaries,
+// sign is the same as for pressure correction, so matrix is negative definite.
+// Boundary coefficient 2 corresponds to the boundary value on the face
+static SparseMatrix laplacian(Index n, Scalar boundaryCoeff = 1)
+{
+    List<Eigen::Triplet<Scalar>> triplets;
+    for (Index i = 0; i < n; i++)
+    {
+        for (Index j = 0; j < n; j++)
+        {
+            Index row = i*n + j;
+            Scalar diagonal = 0;
+            for (auto [isInterior, col] : {std::pair(i > 0, row - n), {i < n-1, row + n}, {j > 0, row - 1}, {j < n-1, row + 1}})
+            {
+                if (isInterior)
+                {
+                    triplets.emplace_back(row, col, 1);
+                }
+                diagonal -= isInterior ? 1 : boundaryCoeff;
+            }
+            triplets.emplace_back(row, row, diagonal);
+        }
+    }
+
+    SparseMatrix A(n*n, n*n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+
+
+// Upwind convection along x with diffusion, matrix is not symmetric
+static SparseMatrix convectionDiffusion(Index n, Scalar peclet)
+{
+    SparseMatrix A = -laplacian(n);
+    for (Index i = 0; i < n; i++)
+    {
+        for (Index j = 0; j < n; j++)
+        {
+            Index row = i*n + j;
+            A.coeffRef(row, row) += peclet;
+            if (j > 0)
+            {
+                A.coeffRef(row, row - 1) -= peclet;
+            }
+        }
+    }
+    A.makeCompressed();
+    return A;
+}
+
+
+static Field<Scalar> randomField(Index size)
+{
+    Field<Scalar> field(size);
+    for (Scalar& value : field)
+    {
+        value = randomScalar();
+    }
+    return field;
+}
+
+
+using namespace LinearSolvers;
+
+static Index solveAndCount
+(
+    SparseMatrix const& A,
+    Field<Scalar> const& b,
+    Solver::Type solverType,
+    Preconditioner::Type preconditionerType
+)
+{
+    constexpr Scalar tolerance = 1e-10;
+
+    auto preconditioner = makePreconditioner(preconditionerType);
+    preconditioner->compute(A);
+
+    auto solver = makeKrylovSolver(solverType);
+    solver->setTolerance(tolerance);
+
+    Field<Scalar> x = Field<Scalar>::Zero(b.rows());
+    EXPECT_TRUE(solver->solve(SparseOperator(A), *preconditioner, b, x));
+    EXPECT_LE((b - A*x).norm() / b.norm(), 10 * tolerance);
+    EXPECT_LE(solver->error(), tolerance);
+
+    return solver->iterations();
+}
+
+
+TEST(TestLinearSolvers, SymmetricSolvers)
+{
+    constexpr Index n = 20;
+    SparseMatrix A = laplacian(n);
+    Field<Scalar> b = randomField(n*n);
+
+    for (auto solverType : {Solver::CG, Solver::BICGSTAB, Solver::GMRES})
+    {
+        for (auto preconditionerType : {Preconditioner::NONE, Preconditioner::JACOBI, Preconditioner::ILU0, Preconditioner::IC0, Preconditioner::SGS})
+        {
+            SCOPED_TRACE(testing::Message() << "solver " << solverType << ", preconditioner " << preconditionerType);
+            solveAndCount(A, b, solverType, preconditionerType);
+        }
+    }
+}
+
+
+TEST(TestLinearSolvers, NonSymmetricSolvers)
+{
+    constexpr Index n = 20;
+    constexpr Scalar peclet = 5;
+    SparseMatrix A = convectionDiffusion(n, peclet);
+    Field<Scalar> b = randomField(n*n);
+
+    for (auto solverType : {Solver::BICGSTAB, Solver::GMRES})
+    {
+        for (auto preconditionerType : {Preconditioner::NONE, Preconditioner::JACOBI, Preconditioner::ILU0, Preconditioner::SGS})
+        {
+            SCOPED_TRACE(testing::Message() << "solver " << solverType << ", preconditioner " << preconditionerType);
+            solveAndCount(A, b, solverType, preconditionerType);
+        }
+    }
+}
+
+
+TEST(TestLinearSolvers, IncompleteCholeskyReducesIterations)
+{
+    constexpr Index n = 40;
+    SparseMatrix A = laplacian(n);
+    Field<Scalar> b = randomField(n*n);
+
+    Index jacobiIterations = solveAndCount(A, b, Solver::CG, Preconditioner::JACOBI);
+    Index ic0Iterations = solveAndCount(A, b, Solver::CG, Preconditioner::IC0);
+
+    EXPECT_LT(2 * ic0Iterations, jacobiIterations);
+}
+
+
+TEST(TestLinearSolvers, MultipleColumnsWithGuess)
+{
+    constexpr Index n = 10;
+    constexpr Scalar tolerance = 1e-12;
+    SparseMatrix A = convectionDiffusion(n, 1);
+
+    Matrix rhs(n*n, 2);
+    rhs.col(0) = randomField(n*n);
+    rhs.col(1) = randomField(n*n);
+
+    Matrix exact = solveSystem(A, rhs, tolerance, Solver::GMRES, Preconditioner::ILU0);
+    Matrix fromGuess = solveSystem(A, rhs, exact, tolerance, Solver::BICGSTAB, Preconditioner::SGS);
+
+    EXPECT_LE((A*exact - rhs).norm() / rhs.norm(), 10 * tolerance);
+    EXPECT_LE((fromGuess - exact).norm() / exact.norm(), 1e-10);
+}
+
+
+TEST(TestLinearSolvers, BlockSolveMatchesColumns)
+{
+    constexpr Index n = 20;
+    constexpr Scalar tolerance = 1e-10;
+
+    // Last column is zero as z velocity in 2D
+    Matrix rhs = Matrix::Zero(n*n, 3);
+    rhs.col(0) = randomField(n*n);
+    rhs.col(1) = 100 * randomField(n*n);
+
+    for (auto solverType : {Solver::CG, Solver::BICGSTAB})
+    {
+        SCOPED_TRACE(testing::Message() << "solver " << solverType);
+        SparseMatrix A = solverType == Solver::CG ? laplacian(n) : convectionDiffusion(n, 5);
+
+        Matrix product;
+        multiplyColumns(A, rhs, product);
+        EXPECT_LE((product - A*rhs).norm(), 1e-12 * (A*rhs).norm());
+
+        auto preconditioner = makePreconditioner(Preconditioner::ILU0);
+        preconditioner->compute(A);
+        auto solver = makeKrylovSolver(solverType);
+        solver->setTolerance(tolerance);
+
+        Matrix X = Matrix::Ones(n*n, 3);
+        EXPECT_TRUE(solver->solveBlock(SparseOperator(A), *preconditioner, rhs, X));
+        Index blockIterations = solver->iterations();
+        EXPECT_TRUE(X.col(2).isZero());
+
+        Index maxIterations = 0;
+        for (Index col = 0; col < 2; col++)
+        {
+            Field<Scalar> b = rhs.col(col);
+            EXPECT_LE((b - A*X.col(col)).norm() / b.norm(), tolerance);
+
+            Field<Scalar> x = Field<Scalar>::Ones(n*n);
+            solver->solve(SparseOperator(A), *preconditioner, b, x);
+            maxIterations = std::max(maxIterations, solver->iterations());
+        }
+        EXPECT_EQ(blockIterations, maxIterations);
+    }
+}
+
+
+TEST(TestLinearSolvers, SlicedEllpackProducts)
+{
+    constexpr Index n = 23;
+    constexpr Scalar tolerance = 1e-10;
+
+    // Extra couplings make rows of different length and the size is not a multiple of chunk size
+    SparseMatrix A = convectionDiffusion(n, 3);
+    for (Index row = 0; row < n*n; row += 7)
+    {
+        A.coeffRef(row, (row * 31) % (n*n)) += 0.1;
+    }
+    A.makeCompressed();
+
+    Matrix X(n*n, 3);
+    for (Index col = 0; col < 3; col++)
+    {
+        X.col(col) = randomField(n*n);
+    }
+
+    SparseOperator sell(A, SparseFormat::SELL);
+    Matrix AX;
+    sell.multiply(X, AX);
+    EXPECT_LE((AX - A*X).norm(), 1e-12 * (A*X).norm());
+    EXPECT_LE((sell * X.col(0) - A*X.col(0)).norm(), 1e-12 * (A*X.col(0)).norm());
+
+    // Float values are kept next to double ones in both formats
+    SparseOperator csr(SparseFormat::CSR);
+    for (SparseOperator* op : {&sell, &csr})
+    {
+        op->setSinglePrecision(true);
+        op->update(A);
+    }
+    Field<float> xSingle = X.col(0).cast<float>();
+    Field<float> sellSingle, csrSingle;
+    sell.multiply(xSingle, sellSingle);
+    csr.multiply(xSingle, csrSingle);
+    EXPECT_LE((sellSingle.cast<Scalar>() - A*X.col(0)).norm(), 1e-5 * (A*X.col(0)).norm());
+    EXPECT_LE((sellSingle - csrSingle).norm(), 1e-5 * csrSingle.norm());
+
+    // New values with the same pattern
+    SparseMatrix scaled = 2 * A;
+    sell.update(scaled);
+    sell.multiply(X, AX);
+    EXPECT_LE((AX - scaled*X).norm(), 1e-12 * (scaled*X).norm());
+    csr.update(scaled);
+    sell.multiply(xSingle, sellSingle);
+    csr.multiply(xSingle, csrSingle);
+    EXPECT_LE((sellSingle.cast<Scalar>() - scaled*X.col(0)).norm(), 1e-5 * (scaled*X.col(0)).norm());
+    EXPECT_LE((csrSingle.cast<Scalar>() - scaled*X.col(0)).norm(), 1e-5 * (scaled*X.col(0)).norm());
+
+    // Other pattern rebuilds the layout
+    SparseMatrix other = laplacian(n);
+    sell.update(other);
+    sell.multiply(X, AX);
+    EXPECT_LE((AX - other*X).norm(), 1e-12 * (other*X).norm());
+
+    sell.update(A);
+    auto preconditioner = makePreconditioner(Preconditioner::ILU0);
+    preconditioner->compute(A);
+    for (auto solverType : {Solver::BICGSTAB, Solver::GMRES})
+    {
+        SCOPED_TRACE(testing::Message() << "solver " << solverType);
+        auto solver = makeKrylovSolver(solverType);
+        solver->setTolerance(tolerance);
+
+        Field<Scalar> b = X.col(0);
+        Field<Scalar> x = Field<Scalar>::Zero(n*n);
+        EXPECT_TRUE(solver->solve(sell, *preconditioner, b, x));
+        EXPECT_LE((b - A*x).norm() / b.norm(), 10 * tolerance);
+    }
+}
+
+
+TEST(TestLinearSolvers, AlgebraicMultigridMeshIndependence)
+{
+    Index coarseIterations = 0;
+    for (Index n : {32, 128})
+    {
+        SparseMatrix A = laplacian(n);
+        Field<Scalar> b = randomField(n*n);
+
+        Index iterations = solveAndCount(A, b, Solver::CG, Preconditioner::AMG);
+        if (coarseIterations == 0)
+        {
+            coarseIterations = iterations;
+        }
+        EXPECT_LE(iterations, coarseIterations + 4);
+    }
+}
+
+
+TEST(TestLinearSolvers, AlgebraicMultigridReuse)
+{
+    constexpr Index n = 30;
+    constexpr Scalar tolerance = 1e-10;
+    SparseMatrix A = convectionDiffusion(n, 2);
+    Field<Scalar> b = randomField(n*n);
+
+    AMGPreconditioner preconditioner;
+    RichardsonSolver solver;
+    solver.setTolerance(tolerance);
+
+    // Same pattern with other values reuses aggregates
+    for (Scalar scale : {1.0, 3.0})
+    {
+        SparseMatrix scaled = scale * A;
+        preconditioner.compute(scaled);
+        EXPECT_GT(preconditioner.getLevelAmount(), 1);
+
+        Field<Scalar> x = Field<Scalar>::Zero(n*n);
+        EXPECT_TRUE(solver.solve(SparseOperator(scaled), preconditioner, b, x));
+        EXPECT_LE((b - scaled*x).norm() / b.norm(), tolerance);
+    }
+}
+
+
+TEST(TestLinearSolvers, GeometricMultigridCycles)
+{
+    constexpr Scalar tolerance = 1e-10;
+
+    for (auto cycleType : {MultigridCycle::V, MultigridCycle::W, MultigridCycle::F})
+    {
+        for (Index n : {33, 128})
+        {
+            SCOPED_TRACE(testing::Message() << "cycle " << cycleType << ", grid " << n);
+
+            SparseMatrix A = laplacian(n, 2);
+            Field<Scalar> b = randomField(n*n);
+
+            GeometricMultigridPreconditioner preconditioner(n, n, cycleType);
+            preconditioner.compute(A);
+            EXPECT_GT(preconditioner.getLevelAmount(), 1);
+
+            RichardsonSolver solver;
+            solver.setTolerance(tolerance);
+
+            Field<Scalar> x = Field<Scalar>::Zero(n*n);
+            EXPECT_TRUE(solver.solve(SparseOperator(A), preconditioner, b, x));
+            EXPECT_LE(solver.iterations(), 20);
+        }
+    }
+}
+
+
+TEST(TestLinearSolvers, PersistentSolverWarmStart)
+{
+    constexpr Index n = 30;
+    constexpr Scalar tolerance = 1e-10;
+    SparseMatrix A = convectionDiffusion(n, 2);
+    Matrix b = randomField(n*n);
+
+    LinearSolver solver(LinearSolvers::Solver::BICGSTAB, makePreconditioner(LinearSolvers::Preconditioner::ILU0));
+    solver.setRefreshThreshold(0.1);
+
+    Matrix x = solver.solve(A, b, tolerance);
+    EXPECT_TRUE(solver.preconditionerUpdated());
+    EXPECT_GT(solver.iterations(), 0);
+    EXPECT_LE((b - A*x).norm() / b.norm(), tolerance);
+
+    // Previous solution already satisfies the same system
+    solver.solve(A, b, tolerance);
+    EXPECT_EQ(solver.iterations(), 0);
+
+    // Small drift of the diagonal keeps the preconditioner
+    SparseMatrix drifted = 1.01 * A;
+    x = solver.solve(drifted, b, tolerance);
+    EXPECT_FALSE(solver.preconditionerUpdated());
+    EXPECT_LE((b - drifted*x).norm() / b.norm(), tolerance);
+
+    SparseMatrix changed = 1.5 * A;
+    x = solver.solve(changed, b, tolerance);
+    EXPECT_TRUE(solver.preconditionerUpdated());
+    EXPECT_LE((b - changed*x).norm() / b.norm(), tolerance);
+}
+
+
+TEST(TestLinearSolvers, BlockIncompleteLU)
+{
+    constexpr Index n = 50;
+    constexpr Index blockSize = 3;
+    constexpr Scalar tolerance = 1e-10;
+
+    // Block tridiagonal matrix with dense blocks, block ILU0 has no fill there and is exact
+    List<Eigen::Triplet<Scalar>> triplets;
+    for (Index blockRow = 0; blockRow < n; blockRow++)
+    {
+        for (Index blockCol = std::max(blockRow - 1, 0); blockCol <= std::min(blockRow + 1, n - 1); blockCol++)
+        {
+            for (Index i = 0; i < blockSize; i++)
+            {
+                for (Index j = 0; j < blockSize; j++)
+                {
+                    Scalar value = randomScalar() + (blockRow == blockCol && i == j ? 10 : 0);
+                    triplets.emplace_back(blockRow * blockSize + i, blockCol * blockSize + j, value);
+                }
+            }
+        }
+    }
+    SparseMatrix A(n * blockSize, n * blockSize);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    Field<Scalar> b = randomField(n * blockSize);
+
+    BlockILU0Preconditioner blockILU(blockSize);
+    blockILU.compute(A);
+    GMRESSolver solver;
+    solver.setTolerance(tolerance);
+
+    Field<Scalar> x = Field<Scalar>::Zero(n * blockSize);
+    EXPECT_TRUE(solver.solve(SparseOperator(A), blockILU, b, x));
+    EXPECT_LE(solver.iterations(), 2);
+    EXPECT_LE((b - A*x).norm() / b.norm(), 10 * tolerance);
+
+    // Blocks of size one are plain ILU0
+    SparseMatrix scalarA = convectionDiffusion(20, 5);
+    Field<Scalar> scalarB = randomField(scalarA.rows());
+    BlockILU0Preconditioner scalarBlockILU(1);
+    ILU0Preconditioner ilu;
+    scalarBlockILU.compute(scalarA);
+    ilu.compute(scalarA);
+
+    Field<Scalar> blockZ, z;
+    scalarBlockILU.apply(scalarB, blockZ);
+    ilu.apply(scalarB, z);
+    EXPECT_LE((blockZ - z).norm(), 1e-12 * z.norm());
+}
+
+
+TEST(TestLinearSolvers, LinearSolveRecords)
+{
+    constexpr Index n = 30;
+    constexpr Scalar tolerance = 1e-10;
+    SparseMatrix A = convectionDiffusion(n, 2);
+    Matrix b = randomField(n*n);
+
+    LinearSolver solver(LinearSolvers::Solver::BICGSTAB, makePreconditioner(LinearSolvers::Preconditioner::ILU0));
+    Matrix x = solver.solve(A, b, tolerance);
+
+    LinearSolveRecord const& record = solver.getRecord();
+    EXPECT_TRUE(record.converged);
+    EXPECT_TRUE(record.preconditionerUpdated);
+    EXPECT_EQ(record.iterations, solver.iterations());
+    EXPECT_LE(record.error, tolerance);
+    EXPECT_NEAR(record.error, (b - A*x).norm() / b.norm(), tolerance);
+    EXPECT_GE(record.setupTime, 0);
+    EXPECT_GT(record.solveTime, 0);
+
+    // Free function reports through the optional record
+    LinearSolveRecord matrixSolverRecord;
+    x = solveSystem(A, b, tolerance, LinearSolvers::Solver::BICGSTAB, LinearSolvers::Preconditioner::ILU0, &matrixSolverRecord);
+    EXPECT_TRUE(matrixSolverRecord.converged);
+    EXPECT_GT(matrixSolverRecord.iterations, 0);
+    EXPECT_LE(matrixSolverRecord.error, tolerance);
+
+    // Too few iterations are reported as not converged
+    LinearSolver capped(LinearSolvers::Solver::BICGSTAB, makePreconditioner(LinearSolvers::Preconditioner::JACOBI));
+    capped.setMaxIterations(2);
+    capped.solve(A, b, tolerance);
+    EXPECT_FALSE(capped.getRecord().converged);
+    EXPECT_GT(capped.getRecord().error, tolerance);
+}
+
+
+TEST(TestLinearSolvers, MixedPrecisionRefinement)
+{
+    constexpr Index n = 30;
+    constexpr Scalar tolerance = 1e-12;
+
+    struct Case
+    {
+        SparseMatrix A;
+        Solver::Type solver;
+        Preconditioner::Type preconditioner;
+        SparseFormat::Type format = SparseFormat::CSR;
+    };
+    List<Case> cases =
+    {
+        {laplacian(n), Solver::CG, Preconditioner::JACOBI},
+        {convectionDiffusion(n, 5), Solver::BICGSTAB, Preconditioner::ILU0},
+        {convectionDiffusion(n, 5), Solver::GMRES, Preconditioner::ILU0, SparseFormat::SELL},
+        {laplacian(n), Solver::CG, Preconditioner::IC0},
+        {laplacian(n), Solver::CG, Preconditioner::SGS, SparseFormat::SELL},
+        {laplacian(n), Solver::CG, Preconditioner::AMG},
+        {laplacian(n, 2), Solver::CG, Preconditioner::GMG}
+    };
+
+    Matrix b = randomField(n*n);
+    for (auto const& [A, solverType, preconditionerType, format] : cases)
+    {
+        SCOPED_TRACE(testing::Message() << "solver " << solverType << ", preconditioner " << preconditionerType << ", format " << format);
+
+        std::unique_ptr<PreconditionerBase> preconditioner;
+        if (preconditionerType == Preconditioner::GMG)
+        {
+            preconditioner = std::make_unique<GeometricMultigridPreconditioner>(n, n);
+        }
+        else
+        {
+            preconditioner = makePreconditioner(preconditionerType);
+        }
+
+        // Float setup applies the same preconditioner up to rounding
+        Field<Scalar> r = b.col(0);
+        Field<Scalar> z;
+        Field<float> zSingle;
+        preconditioner->setSinglePrecision(true);
+        preconditioner->compute(A);
+        preconditioner->apply(r, z);
+        preconditioner->applySingle(r.cast<float>(), zSingle);
+        EXPECT_LE((zSingle.cast<Scalar>() - z).norm(), 1e-4 * z.norm());
+
+        LinearSolver solver(solverType, std::move(preconditioner));
+        solver.setSparseFormat(format);
+        solver.setMixedPrecision(true);
+
+        Matrix x = solver.solve(A, b, Matrix::Zero(n*n, 1), tolerance);
+        EXPECT_LE((b - A*x).norm() / b.norm(), tolerance);
+
+        // Tolerance below what refinement reaches, it stops at the cap and reports the miss
+        Scalar residual = (b - A*x).norm();
+        x = solver.solve(A, b, x, std::numeric_limits<Scalar>::epsilon());
+        EXPECT_FALSE(solver.getRecord().converged);
+        EXPECT_GT(solver.getRecord().error, std::numeric_limits<Scalar>::epsilon());
+        EXPECT_LE((b - A*x).norm(), residual);
+    }
+}
+
+
+TEST(TestLinearSolvers, DirectFactorizationReuse)
+{
+    constexpr Index n = 30;
+    constexpr Scalar tolerance = 1e-12;
+    Field<Scalar> b = randomField(n*n);
+
+    LDLTPreconditioner ldlt;
+    SparseLUPreconditioner lu;
+    RichardsonSolver solver;
+    solver.setTolerance(tolerance);
+
+    // Pressure correction matrix is negative definite
+    SparseMatrix symmetric = -laplacian(n);
+    SparseMatrix nonSymmetric = convectionDiffusion(n, 5);
+
+    auto checkSolve = [&](SparseMatrix const& A, PreconditionerBase& preconditioner)
+    {
+        preconditioner.compute(A);
+
+        Field<Scalar> x = Field<Scalar>::Zero(n*n);
+        solver.solve(SparseOperator(A), preconditioner, b, x);
+        EXPECT_LE((b - A*x).norm() / b.norm(), tolerance);
+        EXPECT_LE(solver.iterations(), 2);
+    };
+
+    for (Scalar scale : {1.0, 2.0, 0.5})
+    {
+        checkSolve(scale * symmetric, ldlt);
+        checkSolve(scale * nonSymmetric, lu);
+    }
+
+    // Values change, pattern stays the same
+    EXPECT_EQ(ldlt.getAnalysisAmount(), 1);
+    EXPECT_EQ(lu.getAnalysisAmount(), 1);
+
+    SparseMatrix smaller = laplacian(n - 1);
+    ldlt.compute(smaller);
+    EXPECT_EQ(ldlt.getAnalysisAmount(), 2);
+}
+
+
+TEST(TestLinearSolvers, RichardsonKeepsBestIterate)
+{
+    constexpr Index n = 20;
+    SparseMatrix A = convectionDiffusion(n, 5);
+    Field<Scalar> b = randomField(n*n);
+
+    // Factorization of a different matrix overshoots, so the first step increases the residual
+    SparseLUPreconditioner staleLU;
+    staleLU.compute(SparseMatrix(0.3 * A));
+    RichardsonSolver solver;
+    solver.setTolerance(1e-12);
+
+    Field<Scalar> x = Field<Scalar>::Zero(n*n);
+    EXPECT_FALSE(solver.solve(SparseOperator(A), staleLU, b, x));
+    EXPECT_EQ(x.norm(), 0);
+    EXPECT_NEAR(solver.error(), 1, 1e-12);
+}
+
+
+TEST(TestLinearSolvers, EisenstatWalkerForcingTerm)
+{
+    ForcingTerm forcingTerm(0.1, 0.9, 0.9, 2);
+
+    EXPECT_DOUBLE_EQ(forcingTerm.reset(), 0.1);
+    // Ratio of residuals is unknown yet
+    EXPECT_DOUBLE_EQ(forcingTerm.next(1.0), 0.1);
+
+    // Slow outer convergence keeps solves loose
+    EXPECT_NEAR(forcingTerm.next(0.9), 0.9 * 0.81, 1e-12);
+
+    // Safeguard limits the drop after a loose solve
+    Scalar afterDrop = forcingTerm.next(1e-3);
+    EXPECT_NEAR(afterDrop, 0.9 * std::pow(0.9 * 0.81, 2), 1e-12);
+
+    // Safeguard fades out and fast outer convergence tightens the solves
+    EXPECT_NEAR(forcingTerm.next(1e-6), 0.9 * std::pow(afterDrop, 2), 1e-12);
+    EXPECT_LT(forcingTerm.next(1e-9), 1e-5);
+
+    // Residual growth is capped
+    EXPECT_DOUBLE_EQ(forcingTerm.next(1.0), 0.9);
+
+    // New time step starts over
+    EXPECT_DOUBLE_EQ(forcingTerm.reset(), 0.1);
+}